@@ -1,12 +1,16 @@
 #include "logger.hpp"
 
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 struct Logger::LoggerImpl
 {
     LoggerImpl() = default;
 
-    std::map<std::string, SinkPtr> sinks;
+    // The id of each stream name, and the sink for each stream indexed by its
+    // id. Streams that don't have a sink yet hold an empty pointer.
+    std::unordered_map<std::string, StreamId> streams;
+    std::vector<SinkPtr> sinks;
 };
 
 Logger::Logger() :
@@ -22,7 +26,16 @@ Logger& Logger::getInstance()
 void Logger::print(std::string const& stream, std::string const& message)
 {
     // First check if the stream actually exists.
-    if (mImpl->sinks.find(stream) != mImpl->sinks.end())
+    auto it = mImpl->streams.find(stream);
+    if (it != mImpl->streams.end())
+    {
+        print(it->second, message);
+    }
+}
+
+void Logger::print(StreamId stream, std::string const& message)
+{
+    if (stream < mImpl->sinks.size() && mImpl->sinks[stream])
     {
         // The sink exists, so print the message.
         mImpl->sinks[stream]->print(message);
@@ -31,6 +44,21 @@ void Logger::print(std::string const& stream, std::string const& message)
 
 void Logger::addSink(std::string const& name, SinkPtr const& sink)
 {
-    mImpl->sinks.insert({name, sink});
+    // Like inserting into a map, the first sink added for a stream wins.
+    auto id = getStream(name);
+    if (!mImpl->sinks[id])
+    {
+        mImpl->sinks[id] = sink;
+    }
 }
 
+Logger::StreamId Logger::getStream(std::string const& name)
+{
+    auto id = static_cast<StreamId>(mImpl->sinks.size());
+    auto [it, added] = mImpl->streams.emplace(name, id);
+    if (added)
+    {
+        mImpl->sinks.emplace_back();
+    }
+    return it->second;
+}
@@ -2,6 +2,7 @@
 
 #include "sink.hpp"
 
+#include <cstdint>
 #include <memory>
 
 class Logger
@@ -15,11 +16,21 @@ class Logger
     void operator=(Logger const&) = delete;
 
 public:
+    // Streams can also be referred to by id, which saves looking up the name
+    // every time we print.
+    using StreamId = std::uint32_t;
+
     static Logger& getInstance();
 
     void print(std::string const& stream, std::string const& message);
+    void print(StreamId stream, std::string const& message);
+
     void addSink(std::string const& name, SinkPtr const& sink);
 
+    // Returns the id for the stream name. The stream doesn't need to have a
+    // sink yet.
+    StreamId getStream(std::string const& name);
+
 private:
     struct LoggerImpl;
     std::unique_ptr<LoggerImpl> mImpl;
@@ -12,5 +12,9 @@ int main()
     Logger::getInstance().print("cout", "Hello World");
     foo();
 
+    // Looking the stream up once saves doing it for every message.
+    auto stream = Logger::getInstance().getStream("cout");
+    Logger::getInstance().print(stream, "Printed by id");
+
     return 0;
 }
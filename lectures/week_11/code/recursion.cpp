@@ -9,28 +9,38 @@ struct Node
         data{d}
     {  }
 
-    std::shared_ptr<Node> next;
+    std::unique_ptr<Node> next;
     int data;
 };
 
-using NodePtr = std::shared_ptr<Node>;
+using NodePtr = std::unique_ptr<Node>;
 
 struct List
 {
     NodePtr head;
 
+    // Destroy the nodes one at a time. Letting head go out of scope would
+    // destroy them recursively, which overflows the stack on long lists.
+    ~List()
+    {
+        while (head != nullptr)
+        {
+            head = std::move(head->next);
+        }
+    }
+
     void insert(int a)
     {
-        auto newNode = std::make_shared<Node>(a);
+        auto newNode = std::make_unique<Node>(a);
 
         if (head == nullptr)
         {
-            head = newNode;
+            head = std::move(newNode);
             return;
         }
 
-        newNode->next = head;
-        head = newNode;
+        newNode->next = std::move(head);
+        head = std::move(newNode);
     }
 };
 
@@ -41,11 +51,11 @@ void printForwards(List const& l)
         return;
     }
 
-    auto it = l.head;
+    auto it = l.head.get();
     while (it != nullptr)
     {
         std::cout << it->data << std::endl;
-        it = it->next;
+        it = it->next.get();
     }
 }
 
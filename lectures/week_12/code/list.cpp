@@ -0,0 +1,92 @@
+#include "../../week_5/code/Timer.hpp"
+#include "list.hpp"
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+using atlas::core::Timer;
+
+// The way list.hpp used to link its nodes. Every push pays for a control block
+// and an atomic reference count, and destroying the head destroys the rest of
+// the list recursively.
+template <typename T>
+class SharedList
+{
+public:
+    void push_front(T value)
+    {
+        auto node = std::make_shared<Node>(value);
+        node->next = mHead;
+        mHead = node;
+    }
+
+private:
+    struct Node
+    {
+        Node(T value) :
+            data{value}
+        {  }
+
+        T data;
+        std::shared_ptr<Node> next;
+    };
+
+    std::shared_ptr<Node> mHead;
+};
+
+template <typename ListType>
+void buildAndDestroy(std::size_t size, long long& build, long long& destroy)
+{
+    Timer<std::chrono::milliseconds> timer;
+    auto list = std::make_unique<ListType>();
+
+    timer.start();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        list->push_front(static_cast<int>(i));
+    }
+    build = timer.elapsed().count();
+
+    timer.start();
+    list.reset();
+    destroy = timer.elapsed().count();
+}
+
+int main()
+{
+    // Move-only values can now be stored, and both ends are O(1).
+    {
+        List<std::unique_ptr<std::string>> list;
+        list.emplace_back(std::make_unique<std::string>("world"));
+        list.emplace_front(std::make_unique<std::string>("hello"));
+        while (!list.empty())
+        {
+            std::cout << *list.pop_front() << std::endl;
+        }
+    }
+
+    // The shared_ptr list overflows the stack when it is destroyed long before
+    // it reaches the larger sizes, so it is only timed on the small ones.
+    constexpr std::size_t maxSharedSize = 100000;
+
+    std::cout << "size\tshared build\tshared destroy\tunique build\t" <<
+        "unique destroy (ms)" << std::endl;
+    for (std::size_t size = 1000; size <= 10000000; size *= 10)
+    {
+        std::string sharedBuild{"-"}, sharedDestroy{"-"};
+        long long build, destroy;
+        if (size <= maxSharedSize)
+        {
+            buildAndDestroy<SharedList<int>>(size, build, destroy);
+            sharedBuild = std::to_string(build);
+            sharedDestroy = std::to_string(destroy);
+        }
+
+        buildAndDestroy<List<int>>(size, build, destroy);
+        std::cout << size << "\t" << sharedBuild << "\t\t" << sharedDestroy <<
+            "\t\t" << build << "\t\t" << destroy << std::endl;
+    }
+
+    return 0;
+}
@@ -1,13 +1,12 @@
 #include <memory>
 #include <initializer_list>
+#include <utility>
 
 template <typename T>
 class List
 {
 public:
-    List() : 
-        mHead{nullptr}
-    {  }
+    List() = default;
 
     List(std::initializer_list<T> const& list)
     {
@@ -17,29 +16,110 @@ public:
         }
     }
 
+    List(List const& other)
+    {
+        for (auto it = other.mHead.get(); it != nullptr; it = it->next.get())
+        {
+            push_back(it->data);
+        }
+    }
+
+    List(List&& other) noexcept :
+        mHead{std::move(other.mHead)},
+        mTail{other.mTail}
+    {
+        other.mTail = nullptr;
+    }
+
+    List& operator=(List other)
+    {
+        std::swap(mHead, other.mHead);
+        std::swap(mTail, other.mTail);
+        return *this;
+    }
+
+    // Letting the unique_ptr destroy the nodes would recurse once per node,
+    // which overflows the stack on long lists. Unlink them one at a time
+    // instead.
+    ~List()
+    {
+        clear();
+    }
+
     void push_front(T value)
     {
-        auto node = std::make_shared<Node>(value);
-        node->next = mHead;
-        mHead = node;
+        emplace_front(std::move(value));
+    }
+
+    void push_back(T value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args)
+    {
+        auto node = std::make_unique<Node>(std::forward<Args>(args)...);
+        node->next = std::move(mHead);
+        mHead = std::move(node);
+        if (mTail == nullptr)
+        {
+            mTail = mHead.get();
+        }
+
+        return mHead->data;
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        auto node = std::make_unique<Node>(std::forward<Args>(args)...);
+        auto raw = node.get();
+        if (mTail == nullptr)
+        {
+            mHead = std::move(node);
+        }
+        else
+        {
+            mTail->next = std::move(node);
+        }
+
+        mTail = raw;
+        return raw->data;
+    }
+
+    T pop_front()
+    {
+        auto node = std::move(mHead);
+        mHead = std::move(node->next);
+        if (mHead == nullptr)
+        {
+            mTail = nullptr;
+        }
+
+        return std::move(node->data);
     }
 
+    // The list is singly linked, so we still have to walk it to find the node
+    // before the tail.
     T pop_back()
     {
-        auto it = mHead;
-        if (it->next == nullptr)
+        if (mHead->next == nullptr)
         {
-            mHead = nullptr;
-            return it->data;
+            auto node = std::move(mHead);
+            mTail = nullptr;
+            return std::move(node->data);
         }
 
-        while (it->next != nullptr && it->next->next != nullptr)
+        auto it = mHead.get();
+        while (it->next->next != nullptr)
         {
-            it = it->next;
+            it = it->next.get();
         }
-        auto back = it->next;
-        it->next = nullptr;
-        return back->data;
+
+        auto back = std::move(it->next);
+        mTail = it;
+        return std::move(back->data);
     }
 
     bool empty() const
@@ -47,15 +127,26 @@ public:
         return mHead == nullptr;
     }
 
+    void clear()
+    {
+        while (mHead != nullptr)
+        {
+            // Detach the rest of the list before the head is destroyed.
+            mHead = std::move(mHead->next);
+        }
+        mTail = nullptr;
+    }
+
 private:
     struct Node;
 
-    using NodePtr = std::shared_ptr<Node>;
+    using NodePtr = std::unique_ptr<Node>;
 
     struct Node
     {
-        Node(T value) :
-            data{value},
+        template <typename... Args>
+        Node(Args&&... args) :
+            data(std::forward<Args>(args)...),
             next{nullptr}
         {  }
 
@@ -64,4 +155,8 @@ private:
     };
 
     NodePtr mHead;
+
+    // The list owns every node through mHead, so the tail is just a plain
+    // pointer to the last one.
+    Node* mTail{nullptr};
 };
@@ -0,0 +1,134 @@
+#include "../../week_5/code/Timer.hpp"
+#include "mpmcqueue.hpp"
+
+#include <iostream>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+using atlas::core::Timer;
+
+// The obvious way of sharing a queue: one lock around a std::queue, with the
+// same capacity limit as the lock-free queue.
+template <typename T>
+class MutexQueue
+{
+public:
+    MutexQueue(std::size_t capacity) :
+        mCapacity{capacity}
+    {  }
+
+    void push(T val)
+    {
+        std::unique_lock<std::mutex> lock{mMutex};
+        mNotFull.wait(lock, [this]() { return mQueue.size() < mCapacity; });
+        mQueue.push(std::move(val));
+        mNotEmpty.notify_one();
+    }
+
+    T pop()
+    {
+        std::unique_lock<std::mutex> lock{mMutex};
+        mNotEmpty.wait(lock, [this]() { return !mQueue.empty(); });
+        auto val = std::move(mQueue.front());
+        mQueue.pop();
+        mNotFull.notify_one();
+        return val;
+    }
+
+private:
+    std::size_t mCapacity;
+    std::queue<T> mQueue;
+    std::mutex mMutex;
+    std::condition_variable mNotFull;
+    std::condition_variable mNotEmpty;
+};
+
+// Runs the given number of producers and consumers through the queue and
+// returns the number of values transferred per microsecond.
+template <typename Queue>
+double run(std::size_t threads, std::size_t count)
+{
+    constexpr std::size_t capacity = 1024;
+    Queue queue{capacity};
+    std::vector<long long> sums(threads);
+    std::vector<std::thread> workers;
+    auto perThread = count / threads;
+
+    Timer<std::chrono::microseconds> timer;
+    timer.start();
+    for (std::size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&queue, perThread]()
+        {
+            for (std::size_t i = 0; i < perThread; ++i)
+            {
+                queue.push(static_cast<long long>(i));
+            }
+        });
+
+        workers.emplace_back([&queue, &sums, perThread, t]()
+        {
+            long long sum{0};
+            for (std::size_t i = 0; i < perThread; ++i)
+            {
+                sum += queue.pop();
+            }
+            sums[t] = sum;
+        });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    auto elapsed = timer.elapsed().count();
+
+    long long total{0};
+    for (auto sum : sums)
+    {
+        total += sum;
+    }
+
+    auto n = static_cast<long long>(perThread);
+    if (total != static_cast<long long>(threads) * n * (n - 1) / 2)
+    {
+        std::cout << "Wrong sum!" << std::endl;
+    }
+
+    return static_cast<double>(perThread * threads) / elapsed;
+}
+
+int main()
+{
+    constexpr std::size_t count = 4000000;
+
+    // Quick single threaded check of the non-blocking interface.
+    {
+        MpmcQueue<int> q{4};
+        int val{0};
+        for (int i = 0; i < 5; ++i)
+        {
+            val = i;
+            std::cout << "push " << i << ": " << q.try_push(val) << std::endl;
+        }
+
+        while (q.try_pop(val))
+        {
+            std::cout << "pop: " << val << std::endl;
+        }
+    }
+
+    std::cout << "producers/consumers\tmutex\tmpmc (values/us)" << std::endl;
+    for (std::size_t threads = 1; threads <= 32; threads *= 2)
+    {
+        auto locked = run<MutexQueue<long long>>(threads, count);
+        auto lockFree = run<MpmcQueue<long long>>(threads, count);
+        std::cout << threads << "\t\t\t" << locked << "\t" << lockFree <<
+            std::endl;
+    }
+
+    return 0;
+}
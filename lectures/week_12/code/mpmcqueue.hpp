@@ -0,0 +1,218 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstddef>
+
+// A bounded queue that any number of threads can push to and pop from at the
+// same time. Every slot carries a sequence number that says whose turn it is:
+// when the sequence equals the position a producer wants, the slot is free,
+// and when it equals that position plus one, the slot holds a value for the
+// consumer at that position. Threads claim positions with a compare-exchange
+// and then only touch their own slot, so there is no lock on the fast path.
+//
+// The try_ functions never wait. push and pop spin for a short while and then
+// go to sleep on a condition variable until the other side makes room.
+template <typename T>
+class MpmcQueue
+{
+public:
+    // The capacity is rounded up to a power of two.
+    MpmcQueue(std::size_t capacity)
+    {
+        std::size_t size{2};
+        while (size < capacity)
+        {
+            size *= 2;
+        }
+
+        mMask = size - 1;
+        mCells = std::make_unique<Cell[]>(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(MpmcQueue const&) = delete;
+    void operator=(MpmcQueue const&) = delete;
+
+    // val is only moved from if the push succeeds.
+    bool try_push(T& val)
+    {
+        if (pushSlot(val))
+        {
+            wake(mPopWaiters, mNotEmpty);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool try_pop(T& val)
+    {
+        if (popSlot(val))
+        {
+            wake(mPushWaiters, mNotFull);
+            return true;
+        }
+
+        return false;
+    }
+
+    void push(T val)
+    {
+        for (int i = 0; i < SpinCount; ++i)
+        {
+            if (try_push(val))
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        wait(mPushWaiters, mNotFull, [&]() { return pushSlot(val); });
+        wake(mPopWaiters, mNotEmpty);
+    }
+
+    T pop()
+    {
+        T val;
+        for (int i = 0; i < SpinCount; ++i)
+        {
+            if (try_pop(val))
+            {
+                return val;
+            }
+            std::this_thread::yield();
+        }
+
+        wait(mPopWaiters, mNotEmpty, [&]() { return popSlot(val); });
+        wake(mPushWaiters, mNotFull);
+        return val;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    // These do the actual work of try_push and try_pop, but don't wake anyone
+    // up. That way they can be called while holding the lock.
+    bool pushSlot(T& val)
+    {
+        auto pos = mTail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            auto seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0)
+            {
+                // The slot is free. Try to claim the position.
+                if (mTail.compare_exchange_weak(pos, pos + 1,
+                            std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The slot still holds a value from a lap ago: we're full.
+                return false;
+            }
+            else
+            {
+                // Another producer got here first.
+                pos = mTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(val);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool popSlot(T& val)
+    {
+        auto pos = mHead.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            auto seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0)
+            {
+                if (mHead.compare_exchange_weak(pos, pos + 1,
+                            std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Nothing has been written here yet: we're empty.
+                return false;
+            }
+            else
+            {
+                pos = mHead.load(std::memory_order_relaxed);
+            }
+        }
+
+        val = std::move(cell->data);
+
+        // Hand the slot to the producer one lap ahead.
+        cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // The waiter count is raised before the last attempt, and the other side
+    // checks it after finishing its operation. The seq_cst ordering on both
+    // sides guarantees that at least one of them sees the other, so a sleeper
+    // can never miss the value (or slot) that would have woken it.
+    template <typename Attempt>
+    void wait(std::atomic<int>& waiters, std::condition_variable& cv,
+            Attempt attempt)
+    {
+        std::unique_lock<std::mutex> lock{mMutex};
+        waiters.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cv.wait(lock, attempt);
+        waiters.fetch_sub(1);
+    }
+
+    void wake(std::atomic<int>& waiters, std::condition_variable& cv)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0)
+        {
+            // Taking the lock makes sure the sleeper is either still before
+            // its last attempt, or already waiting on the condition.
+            std::lock_guard<std::mutex> lock{mMutex};
+            cv.notify_all();
+        }
+    }
+
+    static constexpr int SpinCount{16};
+    static constexpr std::size_t CacheLine{64};
+
+    std::unique_ptr<Cell[]> mCells;
+    std::size_t mMask;
+
+    alignas(CacheLine) std::atomic<std::size_t> mTail{0};
+    alignas(CacheLine) std::atomic<std::size_t> mHead{0};
+
+    alignas(CacheLine) std::mutex mMutex;
+    std::condition_variable mNotFull;
+    std::condition_variable mNotEmpty;
+    std::atomic<int> mPushWaiters{0};
+    std::atomic<int> mPopWaiters{0};
+};
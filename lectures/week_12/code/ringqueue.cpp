@@ -0,0 +1,150 @@
+#include "../../week_5/code/Timer.hpp"
+#include "list.hpp"
+#include "ringqueue.hpp"
+
+#include <iostream>
+#include <queue>
+#include <deque>
+#include <vector>
+#include <string>
+
+using atlas::core::Timer;
+
+// The queue from queue.cpp. Every pop has to walk the entire list to find the
+// back, so draining it is quadratic.
+template <typename T>
+class ListQueue
+{
+public:
+    void push(T val)
+    {
+        mList.push_front(val);
+    }
+
+    T pop()
+    {
+        return mList.pop_back();
+    }
+
+    bool empty() const
+    {
+        return mList.empty();
+    }
+
+private:
+    List<T> mList;
+};
+
+// Fills the queue with size elements, drains it, and returns the time it took
+// in microseconds. The sum of the popped values is checked so that the work
+// can't be optimized away.
+template <typename Queue, typename Pop>
+long long fillAndDrain(std::size_t size, Pop pop)
+{
+    Timer<std::chrono::microseconds> timer;
+    Queue q;
+    timer.start();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        q.push(static_cast<int>(i));
+    }
+
+    long long sum{0};
+    while (!q.empty())
+    {
+        sum += pop(q);
+    }
+    auto elapsed = timer.elapsed().count();
+
+    auto n = static_cast<long long>(size);
+    auto expected = n * (n - 1) / 2;
+    if (sum != expected)
+    {
+        std::cout << "Wrong sum!" << std::endl;
+    }
+
+    return elapsed;
+}
+
+long long bulkFillAndDrain(std::size_t size)
+{
+    constexpr std::size_t batch = 256;
+    std::vector<int> buffer(batch);
+    Timer<std::chrono::microseconds> timer;
+    RingQueue<int> q;
+    long long sum{0};
+
+    timer.start();
+    for (std::size_t i = 0; i < size; i += batch)
+    {
+        auto count = std::min(batch, size - i);
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            buffer[k] = static_cast<int>(i + k);
+        }
+        q.push_n(buffer.begin(), count);
+    }
+
+    while (auto count = q.pop_n(buffer.begin(), batch))
+    {
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            sum += buffer[k];
+        }
+    }
+    auto elapsed = timer.elapsed().count();
+
+    auto n = static_cast<long long>(size);
+    auto expected = n * (n - 1) / 2;
+    if (sum != expected)
+    {
+        std::cout << "Wrong sum!" << std::endl;
+    }
+
+    return elapsed;
+}
+
+int main()
+{
+    // Same example as queue.cpp, but with a value type that can't be copied
+    // cheaply.
+    {
+        RingQueue<std::string> q{"1", "10", "100", "1000"};
+        while (!q.empty())
+        {
+            auto val = q.pop();
+            std::cout << val << std::endl;
+        }
+    }
+
+    // The list queue is quadratic, so only the small sizes are timed for it.
+    constexpr std::size_t maxListSize = 10000;
+
+    std::cout << "size\tList\tstd::queue\tRingQueue\tRingQueue (bulk) (us)" <<
+        std::endl;
+    for (std::size_t size = 1000; size <= 10000000; size *= 10)
+    {
+        std::string list{"-"};
+        if (size <= maxListSize)
+        {
+            list = std::to_string(fillAndDrain<ListQueue<int>>(size,
+                        [](auto& q) { return q.pop(); }));
+        }
+
+        auto stl = fillAndDrain<std::queue<int, std::deque<int>>>(size,
+                [](auto& q)
+                {
+                    auto val = q.front();
+                    q.pop();
+                    return val;
+                });
+        auto ring = fillAndDrain<RingQueue<int>>(size,
+                [](auto& q) { return q.pop(); });
+        auto bulk = bulkFillAndDrain(size);
+
+        std::cout << size << "\t" << list << "\t" << stl << "\t\t" << ring <<
+            "\t\t" << bulk << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <memory>
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+#include <cstddef>
+
+// A FIFO queue stored in a circular buffer. Unlike the list based Queue, both
+// ends of the queue are known at all times, so push and pop never have to walk
+// the container. The capacity is always a power of two, which lets us wrap an
+// index around with a mask instead of a division.
+template <typename T>
+class RingQueue
+{
+public:
+    RingQueue() = default;
+
+    RingQueue(std::initializer_list<T> const& list)
+    {
+        reserve(list.size());
+        for (auto const& elem : list)
+        {
+            push(elem);
+        }
+    }
+
+    RingQueue(RingQueue const& other)
+    {
+        reserve(other.size());
+        for (std::size_t i = other.mHead; i != other.mTail; ++i)
+        {
+            push(*other.slot(i));
+        }
+    }
+
+    RingQueue(RingQueue&& other) noexcept
+    {
+        swap(other);
+    }
+
+    RingQueue& operator=(RingQueue other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~RingQueue()
+    {
+        clear();
+        mAlloc.deallocate(mData, capacity());
+    }
+
+    void push(T val)
+    {
+        emplace(std::move(val));
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        if (size() == capacity())
+        {
+            // The arguments may refer to an element of this queue, as in
+            // q.emplace(q.front()), so the new element is built in the new
+            // buffer before the old one is emptied and freed.
+            auto newCapacity = capacity() == 0 ? MinCapacity : 2 * capacity();
+            auto data = mAlloc.allocate(newCapacity);
+            try
+            {
+                new (data + size()) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                mAlloc.deallocate(data, newCapacity);
+                throw;
+            }
+            adopt(data, newCapacity, 1);
+            return;
+        }
+
+        new (slot(mTail)) T(std::forward<Args>(args)...);
+        ++mTail;
+    }
+
+    // As with the list based queue, the queue must not be empty.
+    T pop()
+    {
+        auto head = slot(mHead);
+        T result{std::move(*head)};
+        head->~T();
+        ++mHead;
+        return result;
+    }
+
+    T& front()
+    {
+        return *slot(mHead);
+    }
+
+    T const& front() const
+    {
+        return *slot(mHead);
+    }
+
+    // Pushes count values read from first. The buffer is grown at most once,
+    // and the values are copied in (at most) two contiguous runs. mTail moves
+    // past each value as soon as it is constructed, so if a copy throws, the
+    // values before it stay in the queue and are destroyed with it.
+    template <typename InputIt>
+    void push_n(InputIt first, std::size_t count)
+    {
+        reserve(size() + count);
+        while (count > 0)
+        {
+            auto dest = slot(mTail);
+            auto run = std::min(count, capacity() -
+                    static_cast<std::size_t>(dest - mData));
+            for (std::size_t i = 0; i < run; ++i, ++first)
+            {
+                new (dest + i) T(*first);
+                ++mTail;
+            }
+            count -= run;
+        }
+    }
+
+    // Pops up to count values into out and returns how many were popped.
+    template <typename OutputIt>
+    std::size_t pop_n(OutputIt out, std::size_t count)
+    {
+        count = std::min(count, size());
+        auto popped = count;
+        while (count > 0)
+        {
+            auto src = slot(mHead);
+            auto run = std::min(count, capacity() -
+                    static_cast<std::size_t>(src - mData));
+            out = std::move(src, src + run, out);
+            std::destroy_n(src, run);
+            mHead += run;
+            count -= run;
+        }
+
+        return popped;
+    }
+
+    bool empty() const
+    {
+        return mHead == mTail;
+    }
+
+    std::size_t size() const
+    {
+        return mTail - mHead;
+    }
+
+    std::size_t capacity() const
+    {
+        return mCapacity;
+    }
+
+    void reserve(std::size_t count)
+    {
+        if (count <= capacity())
+        {
+            return;
+        }
+
+        std::size_t newCapacity{MinCapacity};
+        while (newCapacity < count)
+        {
+            newCapacity *= 2;
+        }
+        grow(newCapacity);
+    }
+
+    void clear()
+    {
+        while (!empty())
+        {
+            slot(mHead)->~T();
+            ++mHead;
+        }
+    }
+
+    void swap(RingQueue& other) noexcept
+    {
+        std::swap(mData, other.mData);
+        std::swap(mCapacity, other.mCapacity);
+        std::swap(mHead, other.mHead);
+        std::swap(mTail, other.mTail);
+    }
+
+private:
+    // Since the capacity is a power of two, capacity - 1 is a mask of all the
+    // bits of a valid index.
+    T* slot(std::size_t i) const
+    {
+        return mData + (i & (mCapacity - 1));
+    }
+
+    void grow(std::size_t newCapacity)
+    {
+        adopt(mAlloc.allocate(newCapacity), newCapacity, 0);
+    }
+
+    // Switches to the buffer data, which holds newCapacity elements, with the
+    // front of the queue at index 0. The extra elements already built in data
+    // just past where the contents go join the queue too. The contents are
+    // moved, or copied if moving might throw, and the old buffer is only
+    // emptied once they are all in place. So if a copy throws, data and
+    // everything in it is freed and the queue is left as it was.
+    void adopt(T* data, std::size_t newCapacity, std::size_t extra)
+    {
+        auto count = size();
+        std::size_t i{0};
+        try
+        {
+            for (; i < count; ++i)
+            {
+                new (data + i) T(std::move_if_noexcept(*slot(mHead + i)));
+            }
+        }
+        catch (...)
+        {
+            std::destroy_n(data, i);
+            std::destroy_n(data + count, extra);
+            mAlloc.deallocate(data, newCapacity);
+            throw;
+        }
+
+        clear();
+        mAlloc.deallocate(mData, capacity());
+        mData = data;
+        mCapacity = newCapacity;
+        mHead = 0;
+        mTail = count + extra;
+    }
+
+    static constexpr std::size_t MinCapacity{16};
+
+    std::allocator<T> mAlloc;
+    T* mData{nullptr};
+    std::size_t mCapacity{0};
+
+    // The head and tail only ever increase. Their difference is the size, and
+    // masking them gives the slot in the buffer.
+    std::size_t mHead{0};
+    std::size_t mTail{0};
+};
@@ -0,0 +1,152 @@
+#include "../../week_5/code/Timer.hpp"
+#include "spscqueue.hpp"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <memory>
+
+using atlas::core::Timer;
+
+// Spin for a little while before giving up the core. Without the yield the
+// benchmark would crawl on machines with fewer cores than threads.
+void backoff(int& spins)
+{
+    if (++spins < 64)
+    {
+        __builtin_ia32_pause();
+        return;
+    }
+
+    spins = 0;
+    std::this_thread::yield();
+}
+
+// Bounce a single value back and forth between two threads. Half of the round
+// trip is the time it takes to hand one value to the other thread.
+double pingPong(std::size_t rounds)
+{
+    // The queues are large because of their padding, so keep them off the
+    // stack.
+    auto ping = std::make_unique<SpscQueue<std::size_t, 64>>();
+    auto pong = std::make_unique<SpscQueue<std::size_t, 64>>();
+
+    std::thread other{[&]()
+    {
+        for (std::size_t i = 0; i < rounds; ++i)
+        {
+            std::size_t val;
+            int spins{0};
+            while (!ping->try_pop(val))
+            {
+                backoff(spins);
+            }
+
+            spins = 0;
+            while (!pong->try_push(val))
+            {
+                backoff(spins);
+            }
+        }
+    }};
+
+    Timer<std::chrono::nanoseconds> timer;
+    timer.start();
+    for (std::size_t i = 0; i < rounds; ++i)
+    {
+        int spins{0};
+        while (!ping->try_push(i))
+        {
+            backoff(spins);
+        }
+
+        std::size_t val;
+        spins = 0;
+        while (!pong->try_pop(val))
+        {
+            backoff(spins);
+        }
+    }
+    auto elapsed = timer.elapsed().count();
+    other.join();
+
+    return static_cast<double>(elapsed) / (2 * rounds);
+}
+
+// Stream count values from one thread to the other, batch at a time, and
+// return the average time per value.
+double throughput(std::size_t count, std::size_t batch)
+{
+    auto queue = std::make_unique<SpscQueue<std::size_t, 4096>>();
+    std::size_t sum{0};
+
+    Timer<std::chrono::nanoseconds> timer;
+    timer.start();
+    std::thread consumer{[&]()
+    {
+        std::vector<std::size_t> buffer(batch);
+        std::size_t received{0};
+        int spins{0};
+        while (received < count)
+        {
+            auto popped = queue->pop_n(buffer.begin(), batch);
+            if (popped == 0)
+            {
+                backoff(spins);
+                continue;
+            }
+
+            for (std::size_t i = 0; i < popped; ++i)
+            {
+                sum += buffer[i];
+            }
+            received += popped;
+        }
+    }};
+
+    std::vector<std::size_t> buffer(batch);
+    std::size_t sent{0};
+    int spins{0};
+    while (sent < count)
+    {
+        auto size = std::min(batch, count - sent);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            buffer[i] = sent + i;
+        }
+
+        auto pushed = queue->push_n(buffer.begin(), size);
+        if (pushed == 0)
+        {
+            backoff(spins);
+        }
+        sent += pushed;
+    }
+
+    consumer.join();
+    auto elapsed = timer.elapsed().count();
+
+    if (sum != count * (count - 1) / 2)
+    {
+        std::cout << "Wrong sum!" << std::endl;
+    }
+
+    return static_cast<double>(elapsed) / count;
+}
+
+int main()
+{
+    constexpr std::size_t rounds = 1000000;
+    constexpr std::size_t count = 50000000;
+
+    std::cout << "Ping-pong latency: " << pingPong(rounds) <<
+        " ns per transfer" << std::endl;
+
+    for (std::size_t batch : {1, 16, 256})
+    {
+        std::cout << "Throughput (batch of " << batch << "): " <<
+            throughput(count, batch) << " ns per value" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+
+// A bounded queue that is safe to use from exactly two threads: one that only
+// pushes (the producer) and one that only pops (the consumer). No locks are
+// needed because each index is only ever written by one of the two threads.
+//
+// The head and tail live on separate cache lines so the two threads don't
+// fight over the same line. On top of that, each side keeps a private copy of
+// the other side's index and only reloads it when the copy says the queue is
+// full (or empty). Most operations therefore never touch the other thread's
+// cache line at all.
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+            "Capacity must be a power of two");
+
+public:
+    SpscQueue() = default;
+
+    // The queue owns atomics, so it can't be copied or moved.
+    SpscQueue(SpscQueue const&) = delete;
+    void operator=(SpscQueue const&) = delete;
+
+    // Producer only. Returns false if the queue is full.
+    bool try_push(T val)
+    {
+        auto tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mCachedHead == Capacity)
+        {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if (tail - mCachedHead == Capacity)
+            {
+                return false;
+            }
+        }
+
+        mData[tail & Mask] = std::move(val);
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false if the queue is empty.
+    bool try_pop(T& val)
+    {
+        auto head = mHead.load(std::memory_order_relaxed);
+        if (head == mCachedTail)
+        {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if (head == mCachedTail)
+            {
+                return false;
+            }
+        }
+
+        val = std::move(mData[head & Mask]);
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer only. Pushes as many of the count values as fit and returns how
+    // many were pushed. The tail is published once for the whole batch.
+    template <typename InputIt>
+    std::size_t push_n(InputIt first, std::size_t count)
+    {
+        auto tail = mTail.load(std::memory_order_relaxed);
+        if (Capacity - (tail - mCachedHead) < count)
+        {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+        }
+
+        count = std::min(count, Capacity - (tail - mCachedHead));
+        for (std::size_t i = 0; i < count; ++i, ++first)
+        {
+            mData[(tail + i) & Mask] = *first;
+        }
+
+        mTail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer only. Pops up to count values into out and returns how many
+    // were popped.
+    template <typename OutputIt>
+    std::size_t pop_n(OutputIt out, std::size_t count)
+    {
+        auto head = mHead.load(std::memory_order_relaxed);
+        if (mCachedTail - head < count)
+        {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+        }
+
+        count = std::min(count, mCachedTail - head);
+        for (std::size_t i = 0; i < count; ++i, ++out)
+        {
+            *out = std::move(mData[(head + i) & Mask]);
+        }
+
+        mHead.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Only a snapshot: the other thread may change it right after we look.
+    bool empty() const
+    {
+        return mHead.load(std::memory_order_acquire) ==
+            mTail.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t Mask{Capacity - 1};
+    static constexpr std::size_t CacheLine{64};
+
+    // Written by the consumer.
+    alignas(CacheLine) std::atomic<std::size_t> mHead{0};
+    std::size_t mCachedTail{0};
+
+    // Written by the producer.
+    alignas(CacheLine) std::atomic<std::size_t> mTail{0};
+    std::size_t mCachedHead{0};
+
+    alignas(CacheLine) std::array<T, Capacity> mData{};
+};
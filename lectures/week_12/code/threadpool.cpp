@@ -0,0 +1,168 @@
+#include "../../week_5/code/Timer.hpp"
+#include "threadpool.hpp"
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+using atlas::core::Timer;
+
+// The serial version from challenge.cpp, except that it sums into a double
+// like parallelSum does. A float sum of ones stops growing at 2^24.
+double accumulate(std::vector<float> const& data,
+        std::function<double(double, float)> const& op)
+{
+    double result{};
+    for (auto elem : data)
+    {
+        result = op(result, elem);
+    }
+    return result;
+}
+
+// Divide and conquer: split the range in two, sum the left half as a separate
+// task while this thread sums the right half, then join.
+double parallelSum(ThreadPool& pool, float const* data, std::size_t size,
+        std::size_t grain)
+{
+    if (size <= grain)
+    {
+        double sum{0};
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            sum += data[i];
+        }
+        return sum;
+    }
+
+    auto half = size / 2;
+    double left{0};
+    TaskGroup group{pool};
+    group.run([&pool, &left, data, half, grain]()
+            {
+                left = parallelSum(pool, data, half, grain);
+            });
+    auto right = parallelSum(pool, data + half, size - half, grain);
+    group.wait();
+    return left + right;
+}
+
+long long fibSerial(int n)
+{
+    if (n < 2)
+    {
+        return n;
+    }
+
+    return fibSerial(n - 1) + fibSerial(n - 2);
+}
+
+// The classic fork-join benchmark. It creates a huge number of small tasks, so
+// it measures the overhead of the scheduler rather than the memory system.
+long long fib(ThreadPool& pool, int n)
+{
+    if (n < 20)
+    {
+        return fibSerial(n);
+    }
+
+    long long x{0};
+    TaskGroup group{pool};
+    group.run([&pool, &x, n]() { x = fib(pool, n - 1); });
+    auto y = fib(pool, n - 2);
+    group.wait();
+    return x + y;
+}
+
+int main()
+{
+    constexpr std::size_t size = 100000000;
+    constexpr std::size_t grain = 1 << 16;
+    std::vector<float> data(size, 1.0f);
+
+    // Nested parallel loops.
+    {
+        ThreadPool pool;
+        std::atomic<int> count{0};
+        parallelFor(pool, 0, 100, 1, [&pool, &count](std::size_t)
+                {
+                    parallelFor(pool, 0, 100, 1,
+                            [&count](std::size_t) { ++count; });
+                });
+        std::cout << "Nested parallelFor ran " << count << " iterations" <<
+            std::endl;
+        if (count != 100 * 100)
+        {
+            return 1;
+        }
+
+        // A grain of 0 is the same as 1.
+        count = 0;
+        parallelFor(pool, 0, 1000, 0, [&count](std::size_t) { ++count; });
+        if (count != 1000)
+        {
+            std::cout << "parallelFor with a grain of 0 went wrong!" <<
+                std::endl;
+            return 1;
+        }
+
+        // An exception thrown by a task comes back out of wait.
+        bool caught{false};
+        try
+        {
+            parallelFor(pool, 0, 1000, 1, [](std::size_t i)
+                    {
+                        if (i == 500)
+                        {
+                            throw std::runtime_error{"task failed"};
+                        }
+                    });
+        }
+        catch (std::runtime_error const&)
+        {
+            caught = true;
+        }
+        if (!caught)
+        {
+            std::cout << "The exception from a task was lost!" << std::endl;
+            return 1;
+        }
+    }
+
+    Timer<std::chrono::milliseconds> timer;
+    timer.start();
+    auto serial = accumulate(data, [](double x, float y) { return x + y; });
+    std::cout << "Serial accumulate: " << serial << " in " <<
+        timer.elapsed().count() << " ms" << std::endl;
+
+    constexpr int fibN{36};
+    auto expectedFib = fibSerial(fibN);
+
+    std::size_t maxThreads = std::thread::hardware_concurrency();
+    std::cout << "threads\tsum (ms)\tfib(36) (ms)" << std::endl;
+    for (std::size_t threads = 1; threads <= std::max<std::size_t>(maxThreads, 1);
+            threads *= 2)
+    {
+        ThreadPool pool{threads};
+
+        timer.start();
+        auto sum = parallelSum(pool, data.data(), data.size(), grain);
+        auto sumTime = timer.elapsed().count();
+
+        timer.start();
+        auto f = fib(pool, fibN);
+        auto fibTime = timer.elapsed().count();
+
+        if (sum != serial || f != expectedFib)
+        {
+            std::cout << "Wrong result!" << std::endl;
+            return 1;
+        }
+
+        std::cout << threads << "\t" << sumTime << "\t\t" << fibTime <<
+            std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,505 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A Chase-Lev deque. The thread that owns it pushes and pops tasks at the
+// bottom, like a stack, while any other thread may steal from the top. The
+// owner only needs a compare-exchange when it is fighting a thief for the very
+// last task, so the common case is just a couple of plain loads and stores.
+class WorkDeque
+{
+public:
+    using Task = std::function<void()>;
+
+    WorkDeque() :
+        mArray{new Array{32}}
+    {
+        mArrays.emplace_back(mArray.load(std::memory_order_relaxed));
+    }
+
+    WorkDeque(WorkDeque const&) = delete;
+    void operator=(WorkDeque const&) = delete;
+
+    // Owner only.
+    void push(Task* task)
+    {
+        auto b = mBottom.load(std::memory_order_relaxed);
+        auto t = mTop.load(std::memory_order_acquire);
+        auto a = mArray.load(std::memory_order_relaxed);
+        if (b - t > a->size() - 1)
+        {
+            a = grow(a, b, t);
+        }
+
+        a->put(b, task);
+        mBottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only. Returns nullptr if the deque is empty.
+    Task* pop()
+    {
+        auto b = mBottom.load(std::memory_order_relaxed) - 1;
+        auto a = mArray.load(std::memory_order_relaxed);
+        mBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = mTop.load(std::memory_order_relaxed);
+
+        Task* task{nullptr};
+        if (t <= b)
+        {
+            task = a->get(b);
+            if (t == b)
+            {
+                // This is the last task, so a thief may be after it too.
+                if (!mTop.compare_exchange_strong(t, t + 1,
+                            std::memory_order_seq_cst,
+                            std::memory_order_relaxed))
+                {
+                    task = nullptr;
+                }
+                mBottom.store(b + 1, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            mBottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return task;
+    }
+
+    // Any thread. Returns nullptr if the deque is empty or another thread won
+    // the race for the top task.
+    Task* steal()
+    {
+        auto t = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto b = mBottom.load(std::memory_order_acquire);
+
+        if (t < b)
+        {
+            auto a = mArray.load(std::memory_order_acquire);
+            auto task = a->get(t);
+            if (mTop.compare_exchange_strong(t, t + 1,
+                        std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    // A circular buffer of tasks. The slots are atomic because a thief may
+    // read a slot while the owner is writing it.
+    class Array
+    {
+    public:
+        Array(std::int64_t size) :
+            mSize{size},
+            mSlots{std::make_unique<std::atomic<Task*>[]>(size)}
+        {  }
+
+        std::int64_t size() const
+        {
+            return mSize;
+        }
+
+        Task* get(std::int64_t i) const
+        {
+            return mSlots[i & (mSize - 1)].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t i, Task* task)
+        {
+            mSlots[i & (mSize - 1)].store(task, std::memory_order_relaxed);
+        }
+
+    private:
+        std::int64_t mSize;
+        std::unique_ptr<std::atomic<Task*>[]> mSlots;
+    };
+
+    // Thieves may still be reading the old array, so it is kept around until
+    // the deque itself goes away.
+    Array* grow(Array* a, std::int64_t b, std::int64_t t)
+    {
+        auto bigger = new Array{2 * a->size()};
+        for (auto i = t; i < b; ++i)
+        {
+            bigger->put(i, a->get(i));
+        }
+
+        mArrays.emplace_back(bigger);
+        mArray.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    static constexpr std::size_t CacheLine{64};
+
+    alignas(CacheLine) std::atomic<std::int64_t> mTop{0};
+    alignas(CacheLine) std::atomic<std::int64_t> mBottom{0};
+    std::atomic<Array*> mArray;
+    std::vector<std::unique_ptr<Array>> mArrays;
+};
+
+// A pool of worker threads. Each worker owns a WorkDeque: tasks submitted
+// from a worker go to the bottom of its own deque, and a worker that runs out
+// of work steals from the top of someone else's. Tasks submitted from outside
+// the pool go to a shared queue. Workers that can't find anything to do go to
+// sleep until more work is submitted.
+class ThreadPool
+{
+public:
+    using Task = WorkDeque::Task;
+
+    ThreadPool(std::size_t numThreads = std::thread::hardware_concurrency())
+    {
+        if (numThreads == 0)
+        {
+            numThreads = 1;
+        }
+
+        for (std::size_t i = 0; i < numThreads; ++i)
+        {
+            mDeques.emplace_back(std::make_unique<WorkDeque>());
+        }
+
+        for (std::size_t i = 0; i < numThreads; ++i)
+        {
+            mWorkers.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mMutex};
+            mStop = true;
+            ++mGeneration;
+        }
+        mWake.notify_all();
+
+        for (auto& worker : mWorkers)
+        {
+            worker.join();
+        }
+
+        // Anything that was never run still has to be freed.
+        for (auto& deque : mDeques)
+        {
+            while (auto task = deque->pop())
+            {
+                delete task;
+            }
+        }
+
+        for (auto task : mShared)
+        {
+            delete task;
+        }
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    void operator=(ThreadPool const&) = delete;
+
+    std::size_t size() const
+    {
+        return mWorkers.size();
+    }
+
+    void submit(Task task)
+    {
+        auto ptr = new Task{std::move(task)};
+        if (tPool == this)
+        {
+            mDeques[tIndex]->push(ptr);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock{mMutex};
+            mShared.push_back(ptr);
+        }
+
+        wakeOne();
+    }
+
+    // Finds one task and runs it. Returns false if there was nothing to run.
+    bool runOne()
+    {
+        auto task = findTask();
+        if (task == nullptr)
+        {
+            return false;
+        }
+
+        (*task)();
+        delete task;
+        return true;
+    }
+
+    // Runs tasks until done() returns true or the pool is stopped. Threads
+    // that are waiting on a TaskGroup call this so that they help instead of
+    // blocking. When there is nothing to run, the thread sleeps like an idle
+    // worker until more work is submitted or wakeAll is called, so it
+    // doesn't keep taking mMutex to look at the shared queue.
+    template <typename Predicate>
+    void runUntil(Predicate done)
+    {
+        while (!done())
+        {
+            if (runOne())
+            {
+                continue;
+            }
+
+            // Nothing to do. Register as a sleeper, then look one last time.
+            // submit and wakeAll check for sleepers after publishing their
+            // change, so either we see it here or they see us and bump the
+            // generation.
+            std::uint64_t generation;
+            {
+                std::lock_guard<std::mutex> lock{mMutex};
+                if (mStop)
+                {
+                    return;
+                }
+                generation = mGeneration;
+            }
+
+            mSleepers.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (done() || runOne())
+            {
+                mSleepers.fetch_sub(1);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock{mMutex};
+            mWake.wait(lock, [this, generation]()
+                    {
+                        return mStop || mGeneration != generation;
+                    });
+            mSleepers.fetch_sub(1);
+        }
+    }
+
+    // Wakes every sleeping thread, so that those in runUntil check their
+    // condition again.
+    void wakeAll()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mSleepers.load(std::memory_order_relaxed) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock{mMutex};
+                ++mGeneration;
+            }
+            mWake.notify_all();
+        }
+    }
+
+private:
+    Task* findTask()
+    {
+        // Our own deque first, newest task first: it is the one most likely
+        // to still be in the cache.
+        if (tPool == this)
+        {
+            if (auto task = mDeques[tIndex]->pop())
+            {
+                return task;
+            }
+        }
+
+        // Then try to steal from a random victim, visiting each deque once.
+        auto start = nextRandom() % mDeques.size();
+        for (std::size_t i = 0; i < mDeques.size(); ++i)
+        {
+            auto victim = (start + i) % mDeques.size();
+            if (tPool == this && victim == tIndex)
+            {
+                continue;
+            }
+
+            if (auto task = mDeques[victim]->steal())
+            {
+                return task;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock{mMutex};
+        if (mShared.empty())
+        {
+            return nullptr;
+        }
+
+        auto task = mShared.front();
+        mShared.pop_front();
+        return task;
+    }
+
+    void workerLoop(std::size_t index)
+    {
+        tPool = this;
+        tIndex = index;
+        runUntil([]() { return false; });
+    }
+
+    void wakeOne()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mSleepers.load(std::memory_order_relaxed) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock{mMutex};
+                ++mGeneration;
+            }
+            mWake.notify_one();
+        }
+    }
+
+    static std::size_t nextRandom()
+    {
+        // xorshift is plenty for picking victims.
+        thread_local std::uint64_t state{
+            std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1};
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<std::size_t>(state);
+    }
+
+    // Which pool (if any) the current thread works for, and its deque.
+    inline static thread_local ThreadPool* tPool{nullptr};
+    inline static thread_local std::size_t tIndex{0};
+
+    std::vector<std::unique_ptr<WorkDeque>> mDeques;
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::deque<Task*> mShared;
+    std::uint64_t mGeneration{0};
+    bool mStop{false};
+    std::atomic<int> mSleepers{0};
+};
+
+// Fork-join on top of the pool. run forks a task, and wait joins all of the
+// tasks forked so far. While waiting, the thread runs other tasks from the
+// pool, so groups can be nested as deep as we like without running out of
+// workers.
+//
+// If a task throws, the exception is caught on the worker and the first one
+// is rethrown from wait, once every task of the group has finished. The
+// destructor only joins, so wait has to be called to see the exception.
+class TaskGroup
+{
+public:
+    TaskGroup(ThreadPool& pool) :
+        mPool{pool}
+    {  }
+
+    ~TaskGroup()
+    {
+        join();
+    }
+
+    TaskGroup(TaskGroup const&) = delete;
+    void operator=(TaskGroup const&) = delete;
+
+    template <typename Function>
+    void run(Function f)
+    {
+        mPending.fetch_add(1, std::memory_order_relaxed);
+        auto pool = &mPool;
+        mPool.submit([this, pool, f]()
+                {
+                    try
+                    {
+                        f();
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock{mErrorMutex};
+                        if (!mError)
+                        {
+                            mError = std::current_exception();
+                        }
+                    }
+                    // Once the count is 0 the group may be gone, so only the
+                    // pool is touched after that.
+                    if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        pool->wakeAll();
+                    }
+                });
+    }
+
+    void wait()
+    {
+        join();
+
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock{mErrorMutex};
+            std::swap(error, mError);
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void join()
+    {
+        mPool.runUntil([this]()
+                {
+                    return mPending.load(std::memory_order_acquire) == 0;
+                });
+    }
+
+    ThreadPool& mPool;
+    std::atomic<std::size_t> mPending{0};
+    std::mutex mErrorMutex;
+    std::exception_ptr mError;
+};
+
+// Calls f(i) for every i in [begin, end). The range is split in half until
+// the pieces are at most grain long (a grain of 0 counts as 1), and the
+// halves run as separate tasks.
+template <typename UnaryFunction>
+void parallelFor(ThreadPool& pool, std::size_t begin, std::size_t end,
+        std::size_t grain, UnaryFunction const& f)
+{
+    if (end - begin <= std::max<std::size_t>(grain, 1))
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            f(i);
+        }
+        return;
+    }
+
+    auto mid = begin + (end - begin) / 2;
+    TaskGroup group{pool};
+    group.run([&pool, begin, mid, grain, &f]()
+            {
+                parallelFor(pool, begin, mid, grain, f);
+            });
+    parallelFor(pool, mid, end, grain, f);
+    group.wait();
+}
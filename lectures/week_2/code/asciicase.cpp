@@ -0,0 +1,176 @@
+#include "../../week_5/code/Timer.hpp"
+#include "asciicase.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+// The loops from q2.cpp and ice02.cpp, one character at a time.
+void scalarInvert(std::string& str)
+{
+    for (auto& ch : str)
+    {
+        auto c = static_cast<unsigned char>(ch);
+        if (std::isupper(c))
+        {
+            ch = static_cast<char>(std::tolower(c));
+        }
+        else if (std::islower(c))
+        {
+            ch = static_cast<char>(std::toupper(c));
+        }
+    }
+}
+
+void scalarLower(std::string& str)
+{
+    for (auto& ch : str)
+    {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+}
+
+void scalarUpper(std::string& str)
+{
+    for (auto& ch : str)
+    {
+        ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+    }
+}
+
+// Text with letters, digits and punctuation, and every so often a byte
+// outside ASCII if asked for.
+std::string makeText(std::size_t size, bool ascii, std::mt19937& gen)
+{
+    std::uniform_int_distribution<int> printable{' ', '~'};
+    std::uniform_int_distribution<int> any{0, 255};
+    std::uniform_int_distribution<int> chance{0, 999};
+    std::string text(size, ' ');
+    for (auto& ch : text)
+    {
+        ch = static_cast<char>((!ascii && chance(gen) == 0) ? any(gen) :
+                printable(gen));
+    }
+    return text;
+}
+
+template <typename Fast, typename Slow>
+bool checkOne(std::string const& text, Fast fast, Slow slow)
+{
+    auto expected = text;
+    slow(expected);
+    auto result = text;
+    fast(result);
+    return result == expected;
+}
+
+bool check(std::string const& text)
+{
+    return checkOne(text, toLower, scalarLower) &&
+        checkOne(text, toUpper, scalarUpper) &&
+        checkOne(text, invertCase, scalarInvert);
+}
+
+// Every byte value at every position of a block, every length around the
+// block size, and random text with and without bytes outside ASCII.
+bool check()
+{
+    for (std::size_t size = 1; size <= 130; ++size)
+    {
+        for (std::size_t pos = 0; pos < size; ++pos)
+        {
+            for (int value = 0; value < 256; ++value)
+            {
+                std::string text(size, 'q');
+                text[pos] = static_cast<char>(value);
+                if (!check(text))
+                {
+                    std::cout << "Mismatch for byte " << value << " at " <<
+                        pos << " of " << size << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    std::mt19937 gen{116};
+    for (std::size_t size : {0, 63, 64, 65, 1000, 100000})
+    {
+        for (bool onlyAscii : {true, false})
+        {
+            auto text = makeText(size, onlyAscii, gen);
+            bool ascii{true};
+            for (auto ch : text)
+            {
+                ascii = ascii && static_cast<unsigned char>(ch) < 128;
+            }
+            if (!check(text) || isAscii(text) != ascii)
+            {
+                std::cout << "Mismatch for random text of " << size <<
+                    std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Convert>
+double benchmark(std::string text, std::size_t repeats, Convert convert)
+{
+    Timer<std::chrono::microseconds> timer;
+    timer.start();
+    for (std::size_t i = 0; i < repeats; ++i)
+    {
+        convert(text);
+    }
+    auto us = static_cast<double>(timer.elapsed().count());
+    return static_cast<double>(text.size() * repeats) / (us * 1.0e3);
+}
+
+int main(int argc, char* argv[])
+{
+    if (!check())
+    {
+        return 1;
+    }
+
+    // The size of the large text in millions of characters can be given on
+    // the command line. The small one fits in the L1 cache.
+    std::size_t millions = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) :
+        100;
+    std::mt19937 gen{116};
+    std::size_t total = std::max<std::size_t>(millions, 1) * 1000000 * 10;
+
+    std::cout << "GB/s" << std::endl;
+    for (std::size_t size : {std::size_t{16384}, millions * 1000000})
+    {
+        auto text = makeText(size, true, gen);
+        auto repeats = std::max<std::size_t>(total / size, 1);
+        std::cout << size << " characters:" << std::endl;
+        std::cout << "  tolower loop " <<
+            benchmark(text, repeats, scalarLower) << ", toLower " <<
+            benchmark(text, repeats, toLower) << std::endl;
+        std::cout << "  toupper loop " <<
+            benchmark(text, repeats, scalarUpper) << ", toUpper " <<
+            benchmark(text, repeats, toUpper) << std::endl;
+        std::cout << "  invert loop " <<
+            benchmark(text, repeats, scalarInvert) << ", invertCase " <<
+            benchmark(text, repeats, invertCase) << std::endl;
+        std::cout << "  isAscii " << benchmark(text, repeats,
+                [](std::string& str)
+                {
+                    if (!isAscii(str))
+                    {
+                        str[0] = 'x';
+                    }
+                }) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Changing the case of a whole string at once, instead of calling
+// std::isupper and std::tolower on every character.
+//
+// Those calls depend on the locale, so the compiler can't see what they do
+// and has to make them one at a time. For ASCII there is nothing to look up:
+// upper and lower case letters differ only in bit 0x20. Setting that bit
+// maps both cases of a letter to lower case, so a single range compare on
+// the result finds every letter, and flipping 0x20 where it is needed
+// changes the case. That works on 64 characters at once.
+//
+// A block of 64 that holds any byte outside ASCII goes through the standard
+// functions instead, one byte at a time. The ASCII blocks assume the rules
+// of the "C" locale, which is the one these programs run in. Under other
+// locales the standard functions may map even ASCII letters differently
+// (in Turkish, std::toupper('i') isn't 'I'), and then the results differ.
+//
+// Compile with -mavx2, or with AVX-512 (-mavx512bw) to do a block in one
+// register. Otherwise SSE2 is used on x86-64, and 8 bytes at a time in a
+// 64-bit integer everywhere else.
+
+enum class CaseChange
+{
+    Lower,
+    Upper,
+    Invert
+};
+
+// Changes the case of one character the way the standard functions would.
+template <CaseChange Change>
+char changeCase(char ch)
+{
+    auto c = static_cast<unsigned char>(ch);
+    switch (Change)
+    {
+    case CaseChange::Lower:
+        return static_cast<char>(std::tolower(c));
+    case CaseChange::Upper:
+        return static_cast<char>(std::toupper(c));
+    case CaseChange::Invert:
+        if (std::isupper(c))
+        {
+            return static_cast<char>(std::tolower(c));
+        }
+        if (std::islower(c))
+        {
+            return static_cast<char>(std::toupper(c));
+        }
+        return ch;
+    }
+    return ch;
+}
+
+// Changes the case of the 64 characters at block and returns true, or leaves
+// them alone and returns false if any of them isn't ASCII.
+template <CaseChange Change>
+bool changeAsciiBlock(char* block)
+{
+#if defined(__AVX512BW__)
+    auto bit = _mm512_set1_epi8(0x20);
+    auto chars = _mm512_loadu_si512(block);
+    if (_mm512_movepi8_mask(chars) != 0)
+    {
+        return false;
+    }
+
+    auto letters = _mm512_cmplt_epu8_mask(
+            _mm512_sub_epi8(_mm512_or_si512(chars, bit), _mm512_set1_epi8('a')),
+            _mm512_set1_epi8(26));
+    auto lower = _mm512_test_epi8_mask(chars, bit);
+    auto flip = (Change == CaseChange::Lower) ? letters & ~lower :
+        (Change == CaseChange::Upper) ? letters & lower : letters;
+    _mm512_storeu_si512(block,
+            _mm512_mask_blend_epi8(flip, chars, _mm512_xor_si512(chars, bit)));
+    return true;
+#elif defined(__AVX2__)
+    auto lo = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+    auto hi = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + 32));
+    if (_mm256_movemask_epi8(_mm256_or_si256(lo, hi)) != 0)
+    {
+        return false;
+    }
+
+    // There are only signed byte compares, so the letters are moved to the
+    // bottom of the signed range: adding 128 - 'a' takes 'a' to -128 and 'z'
+    // to -103.
+    auto bit = _mm256_set1_epi8(0x20);
+    auto shift = _mm256_set1_epi8(static_cast<char>(128 - 'a'));
+    auto limit = _mm256_set1_epi8(-128 + 26);
+    for (auto half : {0, 32})
+    {
+        auto chars = half == 0 ? lo : hi;
+        auto letters = _mm256_cmpgt_epi8(limit,
+                _mm256_add_epi8(_mm256_or_si256(chars, bit), shift));
+        auto flip = _mm256_and_si256(letters, bit);
+        if (Change == CaseChange::Lower)
+        {
+            flip = _mm256_andnot_si256(chars, flip);
+        }
+        else if (Change == CaseChange::Upper)
+        {
+            flip = _mm256_and_si256(chars, flip);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(block + half),
+                _mm256_xor_si256(chars, flip));
+    }
+    return true;
+#elif defined(__SSE2__)
+    __m128i chars[4];
+    auto any = _mm_setzero_si128();
+    for (int i = 0; i < 4; ++i)
+    {
+        chars[i] = _mm_loadu_si128(
+                reinterpret_cast<__m128i const*>(block + 16 * i));
+        any = _mm_or_si128(any, chars[i]);
+    }
+    if (_mm_movemask_epi8(any) != 0)
+    {
+        return false;
+    }
+
+    // The same signed range trick as with AVX2.
+    auto bit = _mm_set1_epi8(0x20);
+    auto shift = _mm_set1_epi8(static_cast<char>(128 - 'a'));
+    auto limit = _mm_set1_epi8(-128 + 26);
+    for (int i = 0; i < 4; ++i)
+    {
+        auto letters = _mm_cmpgt_epi8(limit,
+                _mm_add_epi8(_mm_or_si128(chars[i], bit), shift));
+        auto flip = _mm_and_si128(letters, bit);
+        if (Change == CaseChange::Lower)
+        {
+            flip = _mm_andnot_si128(chars[i], flip);
+        }
+        else if (Change == CaseChange::Upper)
+        {
+            flip = _mm_and_si128(chars[i], flip);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(block + 16 * i),
+                _mm_xor_si128(chars[i], flip));
+    }
+    return true;
+#else
+    constexpr std::uint64_t ones{0x0101010101010101};
+    std::uint64_t chunks[8];
+    std::memcpy(chunks, block, 64);
+    std::uint64_t any{0};
+    for (auto chunk : chunks)
+    {
+        any |= chunk;
+    }
+    if ((any & (0x80 * ones)) != 0)
+    {
+        return false;
+    }
+
+    // Every byte is at most 0x7f, so these sums can't carry into the next
+    // byte, and the top bit of each says whether it is in range.
+    for (auto& chunk : chunks)
+    {
+        auto folded = chunk | (0x20 * ones);
+        auto atLeastA = folded + (0x80 - 'a') * ones;
+        auto pastZ = folded + (0x80 - 'z' - 1) * ones;
+        auto flip = ((atLeastA & ~pastZ) & (0x80 * ones)) >> 2;
+        if (Change == CaseChange::Lower)
+        {
+            flip &= ~chunk;
+        }
+        else if (Change == CaseChange::Upper)
+        {
+            flip &= chunk;
+        }
+        chunk ^= flip;
+    }
+    std::memcpy(block, chunks, 64);
+    return true;
+#endif
+}
+
+// Changes the case of every character of data in place.
+template <CaseChange Change>
+void changeCase(char* data, std::size_t size)
+{
+    auto scalar = [](char* first, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            first[i] = changeCase<Change>(first[i]);
+        }
+    };
+
+    std::size_t offset{0};
+    for (; offset + 64 <= size; offset += 64)
+    {
+        if (!changeAsciiBlock<Change>(data + offset))
+        {
+            scalar(data + offset, 64);
+        }
+    }
+
+    // The last few characters go through a block of their own. The zeros
+    // after them are ASCII and stay zeros.
+    if (offset < size)
+    {
+        auto rest = size - offset;
+        char block[64]{};
+        std::memcpy(block, data + offset, rest);
+        if (changeAsciiBlock<Change>(block))
+        {
+            std::memcpy(data + offset, block, rest);
+        }
+        else
+        {
+            scalar(data + offset, rest);
+        }
+    }
+}
+
+inline void toLower(std::string& str)
+{
+    changeCase<CaseChange::Lower>(str.data(), str.size());
+}
+
+inline void toUpper(std::string& str)
+{
+    changeCase<CaseChange::Upper>(str.data(), str.size());
+}
+
+inline void invertCase(std::string& str)
+{
+    changeCase<CaseChange::Invert>(str.data(), str.size());
+}
+
+// Returns true if every character is ASCII, which is when the case functions
+// never need to fall back to the standard ones.
+inline bool isAscii(std::string_view str)
+{
+    auto data = str.data();
+    auto size = str.size();
+    std::size_t i{0};
+
+#if defined(__AVX512BW__)
+    auto any = _mm512_setzero_si512();
+    for (; i + 64 <= size; i += 64)
+    {
+        any = _mm512_or_si512(any, _mm512_loadu_si512(data + i));
+    }
+    if (_mm512_movepi8_mask(any) != 0)
+    {
+        return false;
+    }
+#elif defined(__AVX2__)
+    auto any = _mm256_setzero_si256();
+    for (; i + 32 <= size; i += 32)
+    {
+        any = _mm256_or_si256(any, _mm256_loadu_si256(
+                    reinterpret_cast<__m256i const*>(data + i)));
+    }
+    if (_mm256_movemask_epi8(any) != 0)
+    {
+        return false;
+    }
+#elif defined(__SSE2__)
+    auto any = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16)
+    {
+        any = _mm_or_si128(any, _mm_loadu_si128(
+                    reinterpret_cast<__m128i const*>(data + i)));
+    }
+    if (_mm_movemask_epi8(any) != 0)
+    {
+        return false;
+    }
+#endif
+
+    std::uint64_t rest{0};
+    for (; i + 8 <= size; i += 8)
+    {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, data + i, 8);
+        rest |= chunk;
+    }
+    for (; i < size; ++i)
+    {
+        rest |= static_cast<unsigned char>(data[i]);
+    }
+    return (rest & 0x8080808080808080) == 0;
+}
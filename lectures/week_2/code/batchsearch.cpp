@@ -0,0 +1,135 @@
+#include "../../week_5/code/Timer.hpp"
+#include "batchsearch.hpp"
+#include "intscan.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+// The findElement from search.cpp.
+bool findElement(std::vector<int> const& vec, int elem)
+{
+    for (auto num : vec)
+    {
+        if (num == elem)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool sameResults(std::vector<int> const& vec, std::vector<int> const& queries)
+{
+    auto counts = countLessThanBatch(vec, queries);
+    auto found = findElementBatch(vec, queries);
+    for (std::size_t q = 0; q < queries.size(); ++q)
+    {
+        if (counts[q] != countLessThanFast(vec, queries[q]) ||
+                found[q] != findElement(vec, queries[q]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    // Small cases first, with duplicates among both the values and the
+    // queries.
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> small{-20, 20};
+    for (std::size_t size = 0; size < 40; ++size)
+    {
+        for (std::size_t numQueries = 0; numQueries < 20; ++numQueries)
+        {
+            std::vector<int> values(size);
+            std::vector<int> queries(numQueries);
+            for (auto& v : values)
+            {
+                v = small(gen);
+            }
+            for (auto& q : queries)
+            {
+                q = small(gen);
+            }
+
+            if (!sameResults(values, queries))
+            {
+                std::cout << "Mismatch for " << size << " values and " <<
+                    numQueries << " queries" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // The number of values in millions can be given on the command line.
+    std::size_t millions = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) :
+        16;
+    std::uniform_int_distribution<int> value{0, 1000000000};
+    std::vector<int> values(millions * 1000000);
+    for (auto& v : values)
+    {
+        v = value(gen);
+    }
+
+    // Searching for one query at a time takes the number of queries times
+    // the size of the vector, so we stop timing it once that gets too long.
+    constexpr double maxVisits{2.0e9};
+    Timer<std::chrono::milliseconds> timer;
+    for (std::size_t numQueries : {1, 16, 256, 4096, 65536})
+    {
+        std::vector<int> queries(numQueries);
+        for (auto& q : queries)
+        {
+            q = value(gen);
+        }
+        std::cout << numQueries << " queries:";
+        auto visits = static_cast<double>(numQueries) *
+            static_cast<double>(values.size());
+
+        timer.start();
+        auto counts = countLessThanBatch(values, queries);
+        std::cout << " countBatch " << timer.elapsed().count() << " ms";
+
+        if (visits <= maxVisits)
+        {
+            timer.start();
+            std::size_t mismatches{0};
+            for (std::size_t q = 0; q < numQueries; ++q)
+            {
+                mismatches += countLessThanFast(values, queries[q]) !=
+                    counts[q];
+            }
+            std::cout << ", countFast each " << timer.elapsed().count() <<
+                " ms" << (mismatches == 0 ? "" : " MISMATCH");
+        }
+
+        timer.start();
+        auto found = findElementBatch(values, queries);
+        std::cout << ", findBatch " << timer.elapsed().count() << " ms";
+
+        if (visits <= maxVisits)
+        {
+            timer.start();
+            std::size_t mismatches{0};
+            for (std::size_t q = 0; q < numQueries; ++q)
+            {
+                mismatches += findElement(values, queries[q]) != found[q];
+            }
+            std::cout << ", findElement each " << timer.elapsed().count() <<
+                " ms" << (mismatches == 0 ? "" : " MISMATCH");
+        }
+
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
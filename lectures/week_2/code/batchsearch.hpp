@@ -0,0 +1,161 @@
+#pragma once
+
+#include "intscan.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Answers many findElement or countLessThan queries against the same vector
+// in a single pass over it, instead of one pass per query.
+//
+// The queries are sorted, and for every element of the vector we look up its
+// rank among them: the number of queries that are less than or equal to it.
+// That one number answers every query at once:
+//
+// - The element is less than exactly the queries from its rank onwards, so
+//   counting how many elements have each rank and adding the counts up gives
+//   countLessThan for all of them.
+// - The element equals a query only if it equals the query just below its
+//   rank.
+//
+// Each lookup is a binary search over the queries, which stay in cache, so
+// the time grows with the size of the vector times the log of the number of
+// queries rather than with their product.
+//
+// A handful of queries is still faster to answer with one vectorized scan
+// each, so below ScanQueries queries that is what we do.
+
+constexpr std::size_t ScanQueries{8};
+
+// Calls f(value, rank) for every element of vec, where rank is the number of
+// elements of sorted that are less than or equal to it (like
+// std::upper_bound). sorted must not be empty.
+//
+// The binary search runs the same number of steps for every value, and the
+// compiler turns each comparison into a conditional move, so there is
+// nothing to mispredict. What's left is that every step has to wait for the
+// load of the step before it. Running eight searches side by side lets those
+// loads overlap.
+template <typename RankFunction>
+void forEachRank(std::vector<int> const& vec, std::vector<int> const& sorted,
+        RankFunction f)
+{
+    constexpr std::size_t Lanes{8};
+
+    auto data = vec.data();
+    auto size = vec.size();
+    auto search = [&sorted, &f](int const* values, std::size_t count)
+    {
+        int const* bases[Lanes];
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            bases[k] = sorted.data();
+        }
+
+        for (auto length = sorted.size(); length > 1; length -= length / 2)
+        {
+            auto half = length / 2;
+            for (std::size_t k = 0; k < count; ++k)
+            {
+                bases[k] = (bases[k][half] <= values[k]) ? bases[k] + half :
+                    bases[k];
+            }
+        }
+
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            f(values[k], static_cast<std::size_t>(bases[k] - sorted.data()) +
+                    (*bases[k] <= values[k]));
+        }
+    };
+
+    std::size_t i{0};
+    for (; i + Lanes <= size; i += Lanes)
+    {
+        search(data + i, Lanes);
+    }
+    search(data + i, size - i);
+}
+
+// Returns countLessThan(vec, queries[i]) for every query, in the same order
+// as the queries.
+inline std::vector<std::size_t> countLessThanBatch(std::vector<int> const& vec,
+        std::vector<int> const& queries)
+{
+    std::vector<std::size_t> result(queries.size());
+    if (queries.size() < ScanQueries)
+    {
+        for (std::size_t q = 0; q < queries.size(); ++q)
+        {
+            result[q] = countLessThanFast(vec, queries[q]);
+        }
+        return result;
+    }
+
+    auto sorted = queries;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<std::size_t> ranks(sorted.size() + 1);
+    forEachRank(vec, sorted, [&ranks](int, std::size_t rank)
+            {
+                ++ranks[rank];
+            });
+
+    // The elements less than sorted[j] are the ones with rank j or less.
+    std::vector<std::size_t> lessThan(sorted.size());
+    std::size_t total{0};
+    for (std::size_t j = 0; j < sorted.size(); ++j)
+    {
+        total += ranks[j];
+        lessThan[j] = total;
+    }
+
+    for (std::size_t q = 0; q < queries.size(); ++q)
+    {
+        auto j = std::lower_bound(sorted.begin(), sorted.end(), queries[q]) -
+            sorted.begin();
+        result[q] = lessThan[static_cast<std::size_t>(j)];
+    }
+
+    return result;
+}
+
+// Returns findElement(vec, queries[i]) for every query, in the same order as
+// the queries.
+inline std::vector<bool> findElementBatch(std::vector<int> const& vec,
+        std::vector<int> const& queries)
+{
+    std::vector<bool> result(queries.size());
+    if (queries.size() < ScanQueries)
+    {
+        for (std::size_t q = 0; q < queries.size(); ++q)
+        {
+            result[q] = std::find(vec.begin(), vec.end(), queries[q]) !=
+                vec.end();
+        }
+        return result;
+    }
+
+    auto sorted = queries;
+    std::sort(sorted.begin(), sorted.end());
+
+    // found[r] is set once an element equals sorted[r - 1]. An element with
+    // rank 0 is below every query, so comparing it with sorted[0] instead is
+    // just as false, and saves a branch.
+    std::vector<char> found(sorted.size() + 1);
+    forEachRank(vec, sorted, [&sorted, &found](int num, std::size_t rank)
+            {
+                found[rank] |= sorted[rank - (rank > 0)] == num;
+            });
+
+    // A query that appears more than once ends up in the last of its copies.
+    for (std::size_t q = 0; q < queries.size(); ++q)
+    {
+        auto rank = std::upper_bound(sorted.begin(), sorted.end(),
+                queries[q]) - sorted.begin();
+        result[q] = found[static_cast<std::size_t>(rank)];
+    }
+
+    return result;
+}
@@ -0,0 +1,256 @@
+#include "../../week_5/code/Timer.hpp"
+#include "csv.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+// The split from split.cpp, which is how we used to read CSV: split the text
+// into lines, split each line on ',' and convert every field.
+std::vector<std::string> split(std::string const& str, char delim = ' ')
+{
+    std::vector<std::string> words{};
+    std::string word{};
+    bool isSpace{false};
+    for (auto ch : str)
+    {
+        if (ch != delim)
+        {
+            isSpace = false;
+            word.push_back(ch);
+        }
+
+        if (ch == delim && !isSpace)
+        {
+            isSpace = true;
+            words.push_back(word);
+            word.clear();
+        }
+
+        if (ch == delim && isSpace)
+        {
+            continue;
+        }
+    }
+
+    if (!isSpace)
+    {
+        words.push_back(word);
+    }
+
+    return words;
+}
+
+// Rows of id,price,quantity,ratio: two integer and two floating point columns,
+// with a fixed number of decimals like most real data.
+std::string makeNumericCsv(std::size_t size)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<std::int64_t> id{0, 10000000};
+    std::uniform_int_distribution<int> cents{0, 1000000};
+    std::uniform_int_distribution<int> quantity{-500, 500};
+    std::uniform_real_distribution<double> ratio{0.0, 1.0};
+
+    std::string text;
+    text.reserve(size + 64);
+    char buffer[64];
+    while (text.size() < size)
+    {
+        text += std::to_string(id(gen));
+        text.push_back(',');
+        auto c = cents(gen);
+        text += std::to_string(c / 100);
+        text.push_back('.');
+        text += std::to_string(c % 100 + 100).substr(1);
+        text.push_back(',');
+        text += std::to_string(quantity(gen));
+        text.push_back(',');
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer),
+                ratio(gen), std::chars_format::fixed, 6);
+        text.append(buffer, result.ptr);
+        text.push_back('\n');
+    }
+
+    return text;
+}
+
+bool checkCases()
+{
+    using T = ColumnType;
+    CsvTable table{{T::String, T::Int64, T::Double}, ',', true};
+    std::string text{"name,count,value\r\n"
+        "plain,1,1.5\r\n"
+        "\"with, comma\",-2,2e3\n"
+        "\n"
+        "\"with \"\"quotes\"\"\",3,0.25\n"
+        "\"multi\nline\",4,-1\n"
+        "\"\",5,6"};
+    if (!table.parse(text) || table.rows() != 5)
+    {
+        std::cout << "Failed at " << table.errorOffset() << std::endl;
+        return false;
+    }
+
+    std::vector<std::string_view> names{"plain", "with, comma",
+        "with \"quotes\"", "multi\nline", ""};
+    std::vector<std::int64_t> counts{1, -2, 3, 4, 5};
+    std::vector<double> values{1.5, 2000, 0.25, -1, 6};
+    if (table.strings(0) != names || table.ints(1) != counts ||
+            table.doubles(2) != values)
+    {
+        return false;
+    }
+
+    // Malformed input: a field too many, a bad number, an unterminated
+    // quote, a quote inside a quoted field that isn't doubled, text after
+    // the closing quote, and quotes in a field that isn't quoted. The
+    // complete records before the error are kept.
+    for (std::string bad : {"a,1,2\nb,2,3,4\n", "a,1,2\nb,x,3\n",
+            "a,1,2\n\"b,2,3\n", "a,1,2\n\"b\"c\"\",2,3\n",
+            "a,1,2\n\"b\"c,2,3\n", "a,1,2\nb\"c\",2,3\n",
+            "a,1,2\nb\"\"c,2,3\n"})
+    {
+        CsvTable badTable{{T::String, T::Int64, T::Double}};
+        if (badTable.parse(bad) || badTable.rows() != 1 ||
+                badTable.strings(0).size() != 1 ||
+                badTable.ints(1).size() != 1)
+        {
+            return false;
+        }
+    }
+
+    // With one column an empty line is a record with an empty field, not a
+    // blank line to skip.
+    CsvTable single{{T::String}};
+    std::vector<std::string_view> lines{"a", "", "b", ""};
+    if (!single.parse("a\n\nb\r\n\r\n") || single.strings(0) != lines)
+    {
+        return false;
+    }
+
+    // Every length the fast paths handle and a few more, with the dot in
+    // every place, against from_chars.
+    std::string digits{"1234567890123456789"};
+    for (std::size_t n = 1; n <= 18; ++n)
+    {
+        for (std::size_t dot = 0; dot <= n; ++dot)
+        {
+            auto number = digits.substr(0, n);
+            if (dot < n)
+            {
+                number.insert(dot, ".");
+            }
+
+            // Padding, so the fast paths can read 16 bytes.
+            std::string padded = number + std::string(16, ',');
+            auto end = padded.data() + padded.size();
+            std::string_view field{padded.data(), number.size()};
+            double expected{0};
+            double value{0};
+            std::from_chars(field.data(), field.data() + field.size(),
+                    expected);
+            if (!parseDouble(field, end, value) || value != expected)
+            {
+                std::cout << "parseDouble(" << number << ") failed" <<
+                    std::endl;
+                return false;
+            }
+
+            std::int64_t expectedInt{0};
+            std::int64_t valueInt{0};
+            std::from_chars(field.data(), field.data() + field.size(),
+                    expectedInt);
+            if (dot == n && (!parseInt64(field, end, valueInt) ||
+                        valueInt != expectedInt))
+            {
+                std::cout << "parseInt64(" << number << ") failed" <<
+                    std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (!checkCases())
+    {
+        std::cout << "CSV parsing is broken!" << std::endl;
+        return 1;
+    }
+
+    // The size of the text in MiB can be given on the command line.
+    std::size_t mib = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 256;
+    auto text = makeNumericCsv(mib << 20);
+    Timer<std::chrono::milliseconds> timer;
+
+    auto report = [&text](std::string const& name, long long ms,
+            double checksum)
+    {
+        std::cout << name << ": " << ms << " ms (" <<
+            static_cast<double>(text.size()) / (ms * 1.0e6) << " GB/s), " <<
+            "checksum " << checksum << std::endl;
+    };
+
+    std::vector<std::int64_t> ids;
+    std::vector<double> prices;
+    std::vector<std::int64_t> quantities;
+    std::vector<double> ratios;
+    {
+        timer.start();
+        std::size_t start{0};
+        while (start < text.size())
+        {
+            auto end = text.find('\n', start);
+            auto fields = split(text.substr(start, end - start), ',');
+            ids.push_back(std::stoll(fields[0]));
+            prices.push_back(std::stod(fields[1]));
+            quantities.push_back(std::stoll(fields[2]));
+            ratios.push_back(std::stod(fields[3]));
+            start = end + 1;
+        }
+        auto elapsed = timer.elapsed().count();
+
+        double checksum{0};
+        for (std::size_t i = 0; i < ids.size(); ++i)
+        {
+            checksum += ids[i] + prices[i] + quantities[i] + ratios[i];
+        }
+        report("split", elapsed, checksum);
+    }
+
+    {
+        using T = ColumnType;
+        timer.start();
+        CsvTable table{{T::Int64, T::Double, T::Int64, T::Double}};
+        if (!table.parse(text))
+        {
+            std::cout << "Parse failed at " << table.errorOffset() << std::endl;
+            return 1;
+        }
+        auto elapsed = timer.elapsed().count();
+
+        double checksum{0};
+        for (std::size_t i = 0; i < table.rows(); ++i)
+        {
+            checksum += table.ints(0)[i] + table.doubles(1)[i] +
+                table.ints(2)[i] + table.doubles(3)[i];
+        }
+        report("CsvTable", elapsed, checksum);
+
+        if (table.ints(0) != ids || table.doubles(1) != prices ||
+                table.ints(2) != quantities || table.doubles(3) != ratios)
+        {
+            std::cout << "Results differ!" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
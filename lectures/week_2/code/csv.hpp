@@ -0,0 +1,641 @@
+#pragma once
+
+#include "delimscan.hpp"
+#include "../../week_3/code/arena.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ColumnType
+{
+    Int64,
+    Double,
+    String
+};
+
+// Converts 8 digits into their value, or returns false if any of them isn't a
+// digit. The first digit is in the lowest byte of chunk. The digits are
+// combined pairwise: 8 single digits into 4 numbers of 2 digits, then 2 of 4
+// digits, then the result. That takes three multiplications instead of
+// eight.
+inline bool convertDigits(std::uint64_t chunk, std::uint64_t& value)
+{
+    constexpr std::uint64_t zeros{0x3030303030303030};
+
+    // A byte has its top bit set after either of these if it isn't a digit.
+    if ((((chunk + 0x4646464646464646) | (chunk - zeros)) &
+                0x8080808080808080) != 0)
+    {
+        return false;
+    }
+
+    chunk -= zeros;
+    chunk = (chunk * 10 + (chunk >> 8)) & 0x00ff00ff00ff00ff;
+    chunk = (chunk * 100 + (chunk >> 16)) & 0x0000ffff0000ffff;
+    value = (chunk * 10000 + (chunk >> 32)) & 0xffffffff;
+    return true;
+}
+
+// Converts the first n (0 to 8) characters of chunk, which must all be
+// digits. They are moved to the top with '0's below them, so that any number
+// of digits takes the same conversion. The shifts are done in two steps so
+// that they stay below 64 when n is 0.
+inline bool convertDigits(std::uint64_t chunk, std::size_t n,
+        std::uint64_t& value)
+{
+    constexpr std::uint64_t zeros{0x3030303030303030};
+
+    auto shift = 4 * (8 - n);
+    auto low = ~(~std::uint64_t{0} << shift << shift);
+    return convertDigits((chunk << shift << shift) | (zeros & low), value);
+}
+
+// Converts the first n (0 to 16) characters at p, which must all be digits.
+// There must be 16 bytes to read at p. The last (up to) 8 digits are read as
+// a chunk of their own, which ends right where the digits do, and the rest
+// from the start, so that any number of digits takes the same two
+// conversions.
+inline bool convertDigits(char const* p, std::size_t n, std::uint64_t& value)
+{
+    auto numLow = std::min<std::size_t>(n, 8);
+    std::uint64_t high;
+    std::uint64_t low;
+    std::memcpy(&high, p, 8);
+    std::memcpy(&low, p + n - numLow, 8);
+
+    std::uint64_t highValue{0};
+    if (!convertDigits(high, n - numLow, highValue) ||
+            !convertDigits(low, numLow, value))
+    {
+        return false;
+    }
+    value += highValue * 100000000;
+    return true;
+}
+
+// Returns where the first '.' in the 16 bytes at p is, or 16 if there is
+// none.
+inline std::size_t findDot(char const* p)
+{
+    constexpr std::uint64_t ones{0x0101010101010101};
+
+    // Bytes that were '.' are 0 after the xor. Below the first zero byte
+    // nothing borrows, so its top bit is the lowest one set.
+    auto found = [](std::uint64_t chunk)
+    {
+        auto x = chunk ^ (ones * '.');
+        return (x - ones) & ~x & (ones * 0x80);
+    };
+
+    std::uint64_t low;
+    std::uint64_t high;
+    std::memcpy(&low, p, 8);
+    std::memcpy(&high, p + 8, 8);
+    low = found(low);
+    high = found(high);
+    return low != 0 ? static_cast<std::size_t>(__builtin_ctzll(low)) / 8 :
+        8 + static_cast<std::size_t>(
+                __builtin_ctzll(high | (std::uint64_t{1} << 63))) / 8;
+}
+
+// Same as std::from_chars for an int64, which the field must hold entirely.
+// end is the end of the whole text: when there are at least 16 bytes from
+// the start of the field we can convert up to 16 digits at once.
+//
+// The sign of numbers in a column is often random, so it is applied without
+// branching on it.
+inline bool parseInt64(std::string_view field, char const* end,
+        std::int64_t& value)
+{
+    auto p = field.data();
+    auto n = field.size();
+    std::size_t negative = n > 0 && *p == '-';
+    p += negative;
+    n -= negative;
+
+    std::uint64_t magnitude{0};
+    if (n >= 1 && n <= 16 && p + 16 <= end)
+    {
+        if (convertDigits(p, n, magnitude))
+        {
+            value = static_cast<std::int64_t>((magnitude ^ (0 - negative)) +
+                    negative);
+            return true;
+        }
+    }
+
+    auto last = field.data() + field.size();
+    auto result = std::from_chars(field.data(), last, value);
+    return !field.empty() && result.ec == std::errc{} && result.ptr == last;
+}
+
+// Same as std::from_chars for a double. Plain decimals with at most 15
+// digits, like most numbers in CSV files, are read as an integer mantissa
+// and divided by a power of ten. Both of those are exact doubles, and IEEE
+// division rounds correctly, so the result is exactly what from_chars would
+// give. Anything else (exponents, long mantissas, inf, nan) goes to
+// from_chars.
+//
+// The digits before and after the dot are converted separately and put
+// together as integer * 10^fracDigits + fraction.
+inline bool parseDouble(std::string_view field, char const* end,
+        double& value)
+{
+    constexpr double powers[]{1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+        1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    constexpr std::uint64_t tens[]{1, 10, 100, 1000, 10000, 100000, 1000000,
+        10000000, 100000000, 1000000000, 10000000000, 100000000000,
+        1000000000000, 10000000000000, 100000000000000, 1000000000000000};
+
+    auto p = field.data();
+    auto n = field.size();
+    std::size_t negative = n > 0 && *p == '-';
+    p += negative;
+    n -= negative;
+
+    if (n >= 1 && n <= 16 && p + 16 <= end)
+    {
+        // Without a dot we act as if there was one right after the number.
+        auto dot = std::min(findDot(p), n);
+        auto fracDigits = n - std::min(dot + 1, n);
+        if (dot >= 1 && (dot == n || fracDigits >= 1) &&
+                dot + fracDigits <= 15)
+        {
+            // The fraction starts past the dot, so reading 16 bytes from
+            // there could run off the end of the text. It is read from a copy
+            // with room behind it instead.
+            char window[32]{};
+            std::memcpy(window, p, 16);
+            std::uint64_t integer{0};
+            std::uint64_t fraction{0};
+            if (convertDigits(window, dot, integer) &&
+                    convertDigits(window + dot + 1, fracDigits, fraction))
+            {
+                auto mantissa = integer * tens[fracDigits] + fraction;
+                value = static_cast<double>(
+                        static_cast<std::int64_t>(mantissa)) /
+                    powers[fracDigits];
+                value = negative ? -value : value;
+                return true;
+            }
+        }
+    }
+
+    auto last = field.data() + field.size();
+    auto result = std::from_chars(field.data(), last, value);
+    return !field.empty() && result.ec == std::errc{} && result.ptr == last;
+}
+
+// Parses delimited text (CSV by default) straight into one typed array per
+// column, following RFC 4180:
+//
+// - Records end with "\n" or "\r\n", and every record must have one field per
+//   column of the schema. Empty lines are skipped, except with a schema of
+//   one column, where an empty line is a record whose only field is empty.
+// - A field may be enclosed in double quotes, in which case it can contain
+//   delimiters, newlines and quotes, the latter written as "".
+//
+// The text is parsed in batches of 64 KiB, in two steps:
+//
+// 1. The batch is scanned 64 characters at a time like in delimscan.hpp. Each
+//    block gives us masks of the quotes, delimiters and newlines in it.
+//    Running a prefix xor over the quote mask marks every character that is
+//    inside quotes. The delimiters and newlines outside quotes are the only
+//    places where a field can end, and their positions are written to an
+//    index.
+// 2. We go through the index and convert each field.
+//
+// Keeping the steps apart means neither loop has to guess how long the other
+// one runs, which costs far fewer mispredicted branches than doing both at
+// once.
+//
+// Numbers are converted in place (see parseInt64 and parseDouble), and
+// strings are string_views into the text, so nothing is allocated per field.
+// The only exception is a string containing "", which has to be unescaped
+// into a copy (kept in an arena). The text must outlive the table.
+class CsvTable
+{
+public:
+    CsvTable(std::vector<ColumnType> const& schema, char delim = ',',
+            bool hasHeader = false) :
+        mDelim{delim},
+        mSkipRecord{hasHeader},
+        mEnds(BatchSize + 8)
+    {
+        for (auto type : schema)
+        {
+            mColumns.push_back({type, {}, {}, {}});
+        }
+    }
+
+    // Parses the text and adds its records to the table. Returns false if the
+    // text is malformed, in which case only the records before the error are
+    // kept and errorOffset() tells where parsing stopped.
+    bool parse(std::string_view text)
+    {
+        Cursor cursor{0, 0, mRows, mSkipRecord};
+        std::uint64_t inQuotes{0};
+        auto numColumns = std::max<std::size_t>(mColumns.size(), 1);
+        for (std::size_t batch = 0; batch < text.size(); batch += BatchSize)
+        {
+            auto numEnds = findFieldEnds(text.substr(batch, BatchSize),
+                    inQuotes);
+            if (batch == 0 && text.size() > BatchSize)
+            {
+                // Guess how many rows there are from the first batch, so the
+                // columns don't keep growing (and copying) as we go.
+                reserveColumns(mRows + numEnds / numColumns *
+                        (text.size() / BatchSize + 1));
+            }
+
+            // Every row but the one we are in the middle of needs a field end
+            // per column, which bounds the number of rows in the batch.
+            resizeColumns(cursor.row + numEnds / numColumns + 2);
+            auto done = parseFields(text, batch, numEnds, cursor);
+            if (done < numEnds)
+            {
+                return fail(batch + mEnds[done], cursor);
+            }
+        }
+
+        if (inQuotes != 0)
+        {
+            // A quote was never closed.
+            return fail(text.size(), cursor);
+        }
+
+        // The last record doesn't need a newline.
+        if (cursor.column > 0 || cursor.fieldStart < text.size())
+        {
+            resizeColumns(cursor.row + 1);
+            if (!endField(text, text.size(), true, cursor))
+            {
+                return fail(text.size(), cursor);
+            }
+        }
+
+        mRows = cursor.row;
+        mSkipRecord = cursor.skipRecord;
+        resizeColumns(mRows);
+        return true;
+    }
+
+    // Removes every row but keeps the memory, so the table can be reused for
+    // the next batch of records.
+    void clear()
+    {
+        for (auto& c : mColumns)
+        {
+            c.ints.clear();
+            c.doubles.clear();
+            c.strings.clear();
+        }
+        mRows = 0;
+    }
+
+    std::size_t rows() const
+    {
+        return mRows;
+    }
+
+    std::size_t columns() const
+    {
+        return mColumns.size();
+    }
+
+    // The values of a column. Only the one matching the column's type has
+    // anything in it.
+    std::vector<std::int64_t> const& ints(std::size_t column) const
+    {
+        return mColumns[column].ints;
+    }
+
+    std::vector<double> const& doubles(std::size_t column) const
+    {
+        return mColumns[column].doubles;
+    }
+
+    std::vector<std::string_view> const& strings(std::size_t column) const
+    {
+        return mColumns[column].strings;
+    }
+
+    // Where in the text the last call to parse failed.
+    std::size_t errorOffset() const
+    {
+        return mErrorOffset;
+    }
+
+private:
+    static constexpr std::size_t BatchSize{1 << 16};
+
+    struct Column
+    {
+        ColumnType type;
+        std::vector<std::int64_t> ints;
+        std::vector<double> doubles;
+        std::vector<std::string_view> strings;
+    };
+
+    // Where parsing is at. It lives in a local variable rather than in the
+    // table while we parse, so the compiler can keep it in registers: the
+    // fields we store could alias members as far as it knows.
+    struct Cursor
+    {
+        std::size_t fieldStart;
+        std::size_t column;
+        std::size_t row;
+        bool skipRecord;
+    };
+
+    // Same as matchMask, but safe to call on the last block of the text,
+    // which may be shorter than 64 characters.
+    static std::uint64_t blockMask(std::string_view text, std::size_t offset,
+            char ch, std::uint64_t valid)
+    {
+        if (offset + 64 <= text.size())
+        {
+            return matchMask(text.data() + offset, ch);
+        }
+
+        char block[64]{};
+        std::memcpy(block, text.data() + offset, text.size() - offset);
+        return matchMask(block, ch) & valid;
+    }
+
+    // Writes the position of every field end in the batch to mEnds and
+    // returns how many there are. inQuotes says whether the batch starts
+    // inside quotes, and is updated for the next one.
+    std::size_t findFieldEnds(std::string_view batch, std::uint64_t& inQuotes)
+    {
+        std::size_t count{0};
+        scanBlocks(batch, mDelim,
+                [&](std::size_t offset, std::uint64_t delims,
+                    std::uint64_t valid)
+                {
+                    auto quotes = blockMask(batch, offset, '"', valid);
+                    auto newlines = blockMask(batch, offset, '\n', valid);
+
+                    // Bit i of quoted is set if character i is inside quotes
+                    // (counting the opening quote but not the closing one).
+                    auto quoted = prefixXor(quotes) ^ inQuotes;
+                    inQuotes = ~std::uint64_t{0} * (quoted >> 63);
+
+                    // Write the positions 8 at a time, which keeps the loop
+                    // the same length for most blocks. Anything written past
+                    // the last one is overwritten by the next block (mEnds
+                    // has room for it).
+                    auto ends = (delims | newlines) & ~quoted;
+                    auto numEnds = static_cast<std::size_t>(
+                            __builtin_popcountll(ends));
+                    auto out = mEnds.data() + count;
+                    auto last = std::uint64_t{1} << 63;
+                    for (std::size_t i = 0; i < numEnds; i += 8)
+                    {
+                        for (std::size_t k = 0; k < 8; ++k)
+                        {
+                            out[i + k] = static_cast<std::uint32_t>(offset +
+                                    __builtin_ctzll(ends | last));
+                            ends &= ends - 1;
+                        }
+                    }
+                    count += numEnds;
+                });
+
+        return count;
+    }
+
+    // Keeps the complete records and drops the fields of the one we were in
+    // the middle of.
+    bool fail(std::size_t offset, Cursor const& cursor)
+    {
+        mErrorOffset = offset;
+        mRows = cursor.row;
+        mSkipRecord = cursor.skipRecord;
+        resizeColumns(mRows);
+        return false;
+    }
+
+    // Bit i of the result is the xor of bits 0 to i of mask.
+    static std::uint64_t prefixXor(std::uint64_t mask)
+    {
+        mask ^= mask << 1;
+        mask ^= mask << 2;
+        mask ^= mask << 4;
+        mask ^= mask << 8;
+        mask ^= mask << 16;
+        mask ^= mask << 32;
+        return mask;
+    }
+
+    void reserveColumns(std::size_t rows)
+    {
+        for (auto& c : mColumns)
+        {
+            switch (c.type)
+            {
+            case ColumnType::Int64:
+                c.ints.reserve(rows);
+                break;
+            case ColumnType::Double:
+                c.doubles.reserve(rows);
+                break;
+            case ColumnType::String:
+                c.strings.reserve(rows);
+                break;
+            }
+        }
+    }
+
+    // While parsing, the columns are made big enough for every row that
+    // could be coming, and fields are written straight to their row. That
+    // is quite a bit faster than push_back, which has to update the size of
+    // the column for every field. Once we are done they are cut down to the
+    // rows we actually have.
+    void resizeColumns(std::size_t rows)
+    {
+        for (auto& c : mColumns)
+        {
+            switch (c.type)
+            {
+            case ColumnType::Int64:
+                c.ints.resize(rows);
+                break;
+            case ColumnType::Double:
+                c.doubles.resize(rows);
+                break;
+            case ColumnType::String:
+                c.strings.resize(rows);
+                break;
+            }
+        }
+    }
+
+    // Handles the field ends in mEnds[0, numEnds), which are relative to the
+    // batch. Returns the index of the first one that doesn't fit the schema,
+    // or numEnds if they all do.
+    std::size_t parseFields(std::string_view text, std::size_t batch,
+            std::size_t numEnds, Cursor& cursor)
+    {
+        auto local = cursor;
+        auto ends = mEnds.data();
+        std::size_t i{0};
+        for (; i < numEnds; ++i)
+        {
+            auto pos = batch + ends[i];
+            if (!endField(text, pos, text[pos] == '\n', local))
+            {
+                break;
+            }
+        }
+
+        cursor = local;
+        return i;
+    }
+
+    // Handles the field that runs from cursor.fieldStart to end. Returns false
+    // if it doesn't fit the schema.
+    bool endField(std::string_view text, std::size_t end, bool endOfRecord,
+            Cursor& cursor)
+    {
+        auto start = cursor.fieldStart;
+        cursor.fieldStart = end + 1;
+        if (endOfRecord)
+        {
+            // The \r of a \r\n isn't part of the field.
+            if (end > start && text[end - 1] == '\r')
+            {
+                --end;
+            }
+
+            if (cursor.column == 0 && end == start && mColumns.size() != 1)
+            {
+                // An empty line.
+                return true;
+            }
+        }
+
+        auto numColumns = mColumns.size();
+        if (cursor.column >= numColumns)
+        {
+            return false;
+        }
+
+        if (!cursor.skipRecord && !addField(mColumns[cursor.column],
+                    cursor.row, text.substr(start, end - start),
+                    text.data() + text.size()))
+        {
+            return false;
+        }
+        ++cursor.column;
+
+        if (endOfRecord)
+        {
+            if (cursor.column != numColumns)
+            {
+                return false;
+            }
+
+            cursor.row += !cursor.skipRecord;
+            cursor.skipRecord = false;
+            cursor.column = 0;
+        }
+
+        return true;
+    }
+
+    bool addField(Column& column, std::size_t row, std::string_view field,
+            char const* end)
+    {
+        if (!field.empty() && field.front() == '"')
+        {
+            return addQuotedField(column, row, field, end);
+        }
+
+        switch (column.type)
+        {
+        case ColumnType::Int64:
+            return parseInt64(field, end, column.ints[row]);
+
+        case ColumnType::Double:
+            return parseDouble(field, end, column.doubles[row]);
+
+        case ColumnType::String:
+            // A quote may only appear in a quoted field.
+            if (field.find('"') != std::string_view::npos)
+            {
+                return false;
+            }
+            column.strings[row] = field;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Takes the quotes off a field before converting it. A string with
+    // quotes inside has to be unescaped.
+    bool addQuotedField(Column& column, std::size_t row,
+            std::string_view field, char const* end)
+    {
+        if (field.size() < 2 || field.back() != '"')
+        {
+            return false;
+        }
+        field = field.substr(1, field.size() - 2);
+
+        switch (column.type)
+        {
+        case ColumnType::Int64:
+            return parseInt64(field, end, column.ints[row]);
+
+        case ColumnType::Double:
+            return parseDouble(field, end, column.doubles[row]);
+
+        case ColumnType::String:
+            if (field.find('"') != std::string_view::npos)
+            {
+                return unescape(field, column.strings[row]);
+            }
+            column.strings[row] = field;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Turns every "" in the field into a single ". Returns false if a quote
+    // isn't doubled, as in "a"b".
+    bool unescape(std::string_view field, std::string_view& result)
+    {
+        mScratch.clear();
+        for (std::size_t i = 0; i < field.size(); ++i)
+        {
+            mScratch.push_back(field[i]);
+            if (field[i] == '"')
+            {
+                if (i + 1 == field.size() || field[i + 1] != '"')
+                {
+                    return false;
+                }
+                ++i;
+            }
+        }
+        result = mArena.store(mScratch);
+        return true;
+    }
+
+    std::vector<Column> mColumns;
+    char mDelim;
+    bool mSkipRecord;
+    std::size_t mRows{0};
+    std::size_t mErrorOffset{0};
+    std::vector<std::uint32_t> mEnds;
+    std::string mScratch;
+    Arena mArena;
+};
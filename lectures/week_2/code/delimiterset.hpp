@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+// A set of delimiter characters, compiled once so that testing a character
+// doesn't depend on how many delimiters there are.
+//
+// For one character at a time we use a 256-entry table indexed by the
+// character. For 64 characters at a time we split every character into its
+// low and high nibble and look each of them up in a 16-entry table with a
+// byte shuffle (pshufb), which does 16 or 32 lookups in one instruction. The
+// two tables are built so that the lookups have a bit in common exactly when
+// the character is a delimiter:
+//
+// - High nibbles whose characters have the same set of low nibbles share a
+//   bit, and highNibbles[h] holds that bit.
+// - lowNibbles[l] holds the bits of every high nibble that has a delimiter
+//   with low nibble l.
+//
+// With 8 bits that works for up to 8 different sets of low nibbles, which
+// covers any realistic set of delimiters (all of ASCII punctuation needs 4).
+// Anything beyond that falls back to the table.
+class DelimiterSet
+{
+public:
+    DelimiterSet(std::string_view delims)
+    {
+        std::array<std::uint16_t, 16> lowSets{};
+        for (auto ch : delims)
+        {
+            auto byte = static_cast<unsigned char>(ch);
+            mTable[byte] = true;
+            lowSets[byte >> 4] |= static_cast<std::uint16_t>(1 << (byte & 15));
+        }
+
+        std::array<std::uint16_t, 8> groups{};
+        std::size_t numGroups{0};
+        for (std::size_t high = 0; high < 16 && mNibbles; ++high)
+        {
+            if (lowSets[high] == 0)
+            {
+                continue;
+            }
+
+            std::size_t group{0};
+            while (group < numGroups && groups[group] != lowSets[high])
+            {
+                ++group;
+            }
+
+            if (group == numGroups)
+            {
+                if (numGroups == groups.size())
+                {
+                    mNibbles = false;
+                    break;
+                }
+                groups[numGroups++] = lowSets[high];
+            }
+            mHighNibbles[high] = static_cast<std::uint8_t>(1 << group);
+        }
+
+        for (std::size_t group = 0; group < numGroups; ++group)
+        {
+            for (std::size_t low = 0; low < 16; ++low)
+            {
+                if ((groups[group] >> low) & 1)
+                {
+                    mLowNibbles[low] |= static_cast<std::uint8_t>(1 << group);
+                }
+            }
+        }
+    }
+
+    bool contains(char ch) const
+    {
+        return mTable[static_cast<unsigned char>(ch)];
+    }
+
+    // Returns a mask with bit i set if block[i] is a delimiter. Reads exactly
+    // 64 bytes.
+    std::uint64_t matchMask(char const* block) const
+    {
+#if defined(__AVX2__)
+        if (mNibbles)
+        {
+            auto low = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+                        reinterpret_cast<__m128i const*>(mLowNibbles.data())));
+            auto high = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+                        reinterpret_cast<__m128i const*>(mHighNibbles.data())));
+            auto nibble = _mm256_set1_epi8(0x0f);
+            auto zero = _mm256_setzero_si256();
+
+            auto classify = [&](char const* chunk)
+            {
+                auto bytes = _mm256_loadu_si256(
+                        reinterpret_cast<__m256i const*>(chunk));
+                auto lo = _mm256_and_si256(bytes, nibble);
+                auto hi = _mm256_and_si256(_mm256_srli_epi16(bytes, 4),
+                        nibble);
+                auto bits = _mm256_and_si256(_mm256_shuffle_epi8(low, lo),
+                        _mm256_shuffle_epi8(high, hi));
+
+                // movemask gives us the characters with no bits in common,
+                // which are the ones that aren't delimiters.
+                return ~static_cast<std::uint32_t>(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(bits, zero)));
+            };
+
+            return (static_cast<std::uint64_t>(classify(block + 32)) << 32) |
+                classify(block);
+        }
+#elif defined(__SSSE3__)
+        if (mNibbles)
+        {
+            auto low = _mm_loadu_si128(
+                    reinterpret_cast<__m128i const*>(mLowNibbles.data()));
+            auto high = _mm_loadu_si128(
+                    reinterpret_cast<__m128i const*>(mHighNibbles.data()));
+            auto nibble = _mm_set1_epi8(0x0f);
+            auto zero = _mm_setzero_si128();
+
+            std::uint64_t mask{0};
+            for (int i = 0; i < 4; ++i)
+            {
+                auto bytes = _mm_loadu_si128(
+                        reinterpret_cast<__m128i const*>(block + 16 * i));
+                auto lo = _mm_and_si128(bytes, nibble);
+                auto hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble);
+                auto bits = _mm_and_si128(_mm_shuffle_epi8(low, lo),
+                        _mm_shuffle_epi8(high, hi));
+                auto others = static_cast<std::uint16_t>(
+                        _mm_movemask_epi8(_mm_cmpeq_epi8(bits, zero)));
+                mask |= static_cast<std::uint64_t>(
+                        static_cast<std::uint16_t>(~others)) << (16 * i);
+            }
+            return mask;
+        }
+#endif
+        std::uint64_t mask{0};
+        for (int i = 0; i < 64; ++i)
+        {
+            mask |= static_cast<std::uint64_t>(contains(block[i])) << i;
+        }
+        return mask;
+    }
+
+private:
+    std::array<bool, 256> mTable{};
+    std::array<std::uint8_t, 16> mLowNibbles{};
+    std::array<std::uint8_t, 16> mHighNibbles{};
+    bool mNibbles{true};
+};
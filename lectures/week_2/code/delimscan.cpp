@@ -0,0 +1,299 @@
+#include "../../week_5/code/Timer.hpp"
+#include "delimscan.hpp"
+#include "tokenizer.hpp"
+#include "stripsplit.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+// The split and strip from strip.cpp, taking their argument by reference so
+// that we only time the loops themselves.
+std::vector<std::string> split(std::string const& line, char delim = ' ')
+{
+    std::vector<std::string> words;
+    std::string word;
+    bool isDelim{false};
+    for (auto ch : line)
+    {
+        if (ch != delim)
+        {
+            isDelim = false;
+            word.push_back(ch);
+        }
+
+        if (ch == delim && !isDelim)
+        {
+            words.push_back(word);
+            word.clear();
+            isDelim = true;
+        }
+
+        if (ch == delim && isDelim)
+        {
+            continue;
+        }
+    }
+
+    if (!isDelim)
+    {
+        words.push_back(word);
+    }
+
+    return words;
+}
+
+std::string strip(std::string const& line, char delim = ' ')
+{
+    std::string result{};
+    bool isDelim{false};
+    for (auto ch : line)
+    {
+        if (ch != delim)
+        {
+            result.push_back(ch);
+            isDelim = false;
+        }
+
+        if (ch == delim && !isDelim)
+        {
+            isDelim = true;
+            result.push_back(ch);
+        }
+
+        if (ch == delim && isDelim)
+        {
+            continue;
+        }
+    }
+
+    return result;
+}
+
+// Random words separated by runs of spaces, in lines of roughly lineSize
+// characters.
+std::string makeText(std::size_t size, std::size_t lineSize)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> length{1, 10};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::uniform_int_distribution<int> spaces{1, 3};
+
+    std::string text;
+    text.reserve(size + lineSize);
+    std::size_t lineStart{0};
+    while (text.size() < size)
+    {
+        for (int i = length(gen); i > 0; --i)
+        {
+            text.push_back(static_cast<char>(letter(gen)));
+        }
+        text.append(spaces(gen), ' ');
+
+        if (text.size() - lineStart > lineSize)
+        {
+            text.push_back('\n');
+            lineStart = text.size();
+        }
+    }
+
+    return text;
+}
+
+bool sameWords(std::string const& text, char delim)
+{
+    auto expected = split(text, delim);
+    std::vector<std::string_view> words;
+    forEachWord(text, delim, [&words](std::string_view w) { words.push_back(w); });
+
+    if (words.size() != expected.size() ||
+            countWords(text, delim) != expected.size() ||
+            stripFast(text, delim) != strip(text, delim))
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        if (words[i] != expected[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// The same check for a set of delimiters: the SIMD version against the
+// scalar stripAndSplit, which gives the same words as split().
+bool sameWords(std::string const& text, DelimiterSet const& delims)
+{
+    std::vector<std::string_view> expected;
+    stripAndSplit(text, delims,
+            [&expected](std::string_view w) { expected.push_back(w); });
+    std::vector<std::string_view> words;
+    split(text, words, delims);
+    return words == expected && countWords(text, delims) == expected.size();
+}
+
+// Replaces every space in the text with a random character from delims.
+std::string mixDelimiters(std::string text, std::string_view delims)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<std::size_t> pick{0, delims.size() - 1};
+    for (auto& ch : text)
+    {
+        if (ch == ' ')
+        {
+            ch = delims[pick(gen)];
+        }
+    }
+    return text;
+}
+
+void report(std::string const& name, std::size_t bytes, long long ms,
+        std::size_t result)
+{
+    std::cout << name << ": " << result << " in " << ms << " ms (" <<
+        static_cast<double>(bytes) / (ms * 1.0e6) << " GB/s)" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    // Corner cases first, including ones that straddle a 64 byte block.
+    std::vector<std::string> cases{"", " ", "   ", "a", " a", "a ", "  a  b  ",
+        "Yay    it's     Friday!", std::string(63, 'x') + "  y",
+        std::string(64, ' ') + "z", std::string(130, 'w'),
+        std::string(70, ' ')};
+    for (auto const& text : cases)
+    {
+        if (!sameWords(text, ' ') || !sameWords(text, DelimiterSet{" "}))
+        {
+            std::cout << "Mismatch on \"" << text << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    // The size of the text in MiB can be given on the command line.
+    std::size_t mib = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    auto text = makeText(mib << 20, 4096);
+    std::string_view view{text};
+    Timer<std::chrono::milliseconds> timer;
+
+    // Split into lines, then count the words on each line.
+    {
+        std::size_t count{0};
+        timer.start();
+        std::size_t start{0};
+        for (std::size_t i = 0; i < text.size(); ++i)
+        {
+            if (text[i] == '\n')
+            {
+                count += split(text.substr(start, i - start)).size();
+                start = i + 1;
+            }
+        }
+        count += split(text.substr(start)).size();
+        report("Scalar lines + split", text.size(), timer.elapsed().count(),
+                count);
+    }
+
+    {
+        std::size_t count{0};
+        std::vector<std::string_view> words;
+        timer.start();
+        for (auto line : Tokenizer{view, '\n'})
+        {
+            split(line, words);
+            count += words.size();
+        }
+        report("Tokenizer", text.size(), timer.elapsed().count(), count);
+    }
+
+    {
+        std::size_t count{0};
+        timer.start();
+        std::size_t start{0};
+        auto countLine = [&](std::size_t end)
+        {
+            forEachWord(view.substr(start, end - start), ' ',
+                    [&count](std::string_view) { ++count; });
+            start = end + 1;
+        };
+        forEachDelimiter(view, '\n', countLine);
+        countLine(view.size());
+        report("SIMD lines + forEachWord", text.size(),
+                timer.elapsed().count(), count);
+    }
+
+    {
+        std::size_t count{0};
+        timer.start();
+        std::size_t start{0};
+        auto countLine = [&](std::size_t end)
+        {
+            count += countWords(view.substr(start, end - start));
+            start = end + 1;
+        };
+        forEachDelimiter(view, '\n', countLine);
+        countLine(view.size());
+        report("SIMD lines + countWords", text.size(),
+                timer.elapsed().count(), count);
+    }
+
+    {
+        timer.start();
+        auto stripped = strip(text);
+        report("Scalar strip", text.size(), timer.elapsed().count(),
+                stripped.size());
+
+        timer.start();
+        auto fast = stripFast(view);
+        report("SIMD strip", text.size(), timer.elapsed().count(),
+                fast.size());
+
+        if (fast != stripped)
+        {
+            std::cout << "Strip results differ!" << std::endl;
+            return 1;
+        }
+    }
+
+    // Splitting on a set of delimiters. Every space in the text is replaced
+    // by one of the delimiters, so each set gives the same words as splitting
+    // the original text on spaces alone.
+    std::string punctuation{" \t\n\r\v\f!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~"};
+    for (auto size : {1, 2, 8, 16, 38})
+    {
+        auto delims = std::string_view{punctuation}.substr(0, size);
+        DelimiterSet set{delims};
+        auto mixed = mixDelimiters(text, delims);
+        std::string_view mixedView{mixed};
+        auto name = std::to_string(size) + " delimiters";
+
+        std::size_t count{0};
+        timer.start();
+        stripAndSplit(mixedView, set, [&count](std::string_view) { ++count; });
+        report("Scalar table, " + name, mixed.size(), timer.elapsed().count(),
+                count);
+
+        std::size_t fastCount{0};
+        timer.start();
+        forEachWord(mixedView, set,
+                [&fastCount](std::string_view) { ++fastCount; });
+        report("SIMD nibbles, " + name, mixed.size(), timer.elapsed().count(),
+                fastCount);
+
+        if (fastCount != count || !sameWords(mixed.substr(0, 1 << 20), set))
+        {
+            std::cout << "Delimiter set results differ!" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
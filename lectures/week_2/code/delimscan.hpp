@@ -0,0 +1,261 @@
+#pragma once
+
+#include "delimiterset.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Vectorized versions of the loops in split and strip. Instead of testing one
+// character at a time, we compare 64 characters against the delimiter at once
+// and get back a 64-bit mask with one bit per character. Word boundaries then
+// fall out of a couple of shifts and ands on the mask, and we only ever loop
+// over the boundaries themselves.
+//
+// Compile with -mavx2 (or -march=native) to use AVX2. Otherwise SSE2 is used
+// on x86-64, and a plain loop everywhere else.
+//
+// Everything below takes either a single delimiter or a DelimiterSet, in
+// which case any character of the set counts as a delimiter.
+
+// Returns a mask with bit i set if block[i] == ch. Reads exactly 64 bytes.
+inline std::uint64_t matchMask(char const* block, char ch)
+{
+#if defined(__AVX2__)
+    auto needle = _mm256_set1_epi8(ch);
+    auto lo = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+    auto hi = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + 32));
+    auto loMask = static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    auto hiMask = static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    return (static_cast<std::uint64_t>(hiMask) << 32) | loMask;
+#elif defined(__SSE2__)
+    auto needle = _mm_set1_epi8(ch);
+    std::uint64_t mask{0};
+    for (int i = 0; i < 4; ++i)
+    {
+        auto chunk = _mm_loadu_si128(
+                reinterpret_cast<__m128i const*>(block + 16 * i));
+        auto bits = static_cast<std::uint16_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+        mask |= static_cast<std::uint64_t>(bits) << (16 * i);
+    }
+    return mask;
+#else
+    std::uint64_t mask{0};
+    for (int i = 0; i < 64; ++i)
+    {
+        mask |= static_cast<std::uint64_t>(block[i] == ch) << i;
+    }
+    return mask;
+#endif
+}
+
+inline std::uint64_t matchMask(char const* block, DelimiterSet const& delims)
+{
+    return delims.matchMask(block);
+}
+
+inline bool isDelimiter(char ch, char delim)
+{
+    return ch == delim;
+}
+
+inline bool isDelimiter(char ch, DelimiterSet const& delims)
+{
+    return delims.contains(ch);
+}
+
+// Calls f(offset, delims, valid) for every 64 character block of the text.
+// delims has a bit set for each delimiter in the block, and valid has a bit
+// set for each character that is actually part of the text (only the last
+// block can be shorter than 64).
+template <typename Delim, typename BlockFunction>
+void scanBlocks(std::string_view text, Delim const& delim, BlockFunction f)
+{
+    std::size_t offset{0};
+    for (; offset + 64 <= text.size(); offset += 64)
+    {
+        f(offset, matchMask(text.data() + offset, delim), ~std::uint64_t{0});
+    }
+
+    if (offset < text.size())
+    {
+        auto rest = text.size() - offset;
+        char block[64]{};
+        std::memcpy(block, text.data() + offset, rest);
+        auto valid = (std::uint64_t{1} << rest) - 1;
+        f(offset, matchMask(block, delim) & valid, valid);
+    }
+}
+
+// Calls f(pos) for the position of every delimiter in the text, in order.
+// With '\n' as the delimiter this gives us the line breaks.
+template <typename Delim, typename UnaryFunction>
+void forEachDelimiter(std::string_view text, Delim const& delim,
+        UnaryFunction f)
+{
+    scanBlocks(text, delim,
+            [&f](std::size_t offset, std::uint64_t delims, std::uint64_t)
+            {
+                while (delims != 0)
+                {
+                    f(offset + __builtin_ctzll(delims));
+                    delims &= delims - 1;
+                }
+            });
+}
+
+// Calls f(word) for every word in the text, with the same words (and the same
+// corner cases) as split().
+template <typename Delim, typename UnaryFunction>
+void forEachWord(std::string_view text, Delim const& delim, UnaryFunction f)
+{
+    // split() gives an empty first word if the text is empty or begins with
+    // a delimiter.
+    if (text.empty() || isDelimiter(text.front(), delim))
+    {
+        f(text.substr(0, 0));
+    }
+
+    // The character before the text counts as a delimiter, so a word that
+    // starts right at the beginning is picked up.
+    std::uint64_t carry{1};
+    std::size_t wordStart{0};
+    scanBlocks(text, delim,
+            [&](std::size_t offset, std::uint64_t delims, std::uint64_t valid)
+            {
+                // Bit i of previous is set if character i - 1 is a delimiter.
+                auto previous = (delims << 1) | carry;
+                carry = delims >> 63;
+
+                // A word starts where a non-delimiter follows a delimiter,
+                // and ends where a delimiter follows a non-delimiter.
+                auto starts = ~delims & valid & previous;
+                auto ends = delims & ~previous;
+
+                auto boundaries = starts | ends;
+                while (boundaries != 0)
+                {
+                    auto bit = __builtin_ctzll(boundaries);
+                    boundaries &= boundaries - 1;
+                    if ((starts >> bit) & 1)
+                    {
+                        wordStart = offset + bit;
+                    }
+                    else
+                    {
+                        f(text.substr(wordStart, offset + bit - wordStart));
+                    }
+                }
+            });
+
+    // The last word runs to the end of the text.
+    if (!text.empty() && !isDelimiter(text.back(), delim))
+    {
+        f(text.substr(wordStart));
+    }
+}
+
+// Same as split(text, delim).size(), but only needs a popcount per block.
+template <typename Delim = char>
+std::size_t countWords(std::string_view text, Delim const& delim = ' ')
+{
+    std::size_t count{0};
+    if (text.empty() || isDelimiter(text.front(), delim))
+    {
+        ++count;
+    }
+
+    std::uint64_t carry{1};
+    scanBlocks(text, delim,
+            [&](std::size_t, std::uint64_t delims, std::uint64_t valid)
+            {
+                auto starts = ~delims & valid & ((delims << 1) | carry);
+                carry = delims >> 63;
+                count += __builtin_popcountll(starts);
+            });
+
+    return count;
+}
+
+// Returns a mask of the characters strip() keeps: every non-delimiter, plus
+// the first delimiter of every run. carry holds whether the character before
+// the block was a delimiter, and is updated for the next block.
+inline std::uint64_t stripMask(std::uint64_t delims, std::uint64_t valid,
+        std::uint64_t& carry)
+{
+    auto previous = (delims << 1) | carry;
+    carry = delims >> 63;
+    return (~delims | ~previous) & valid;
+}
+
+// Calls f(offset, length) for every run of set bits in the mask.
+template <typename RunFunction>
+void forEachRun(std::uint64_t mask, RunFunction f)
+{
+    while (mask != 0)
+    {
+        auto start = __builtin_ctzll(mask);
+        auto rest = ~(mask >> start);
+        auto length = (rest == 0) ? 64 - start : __builtin_ctzll(rest);
+        f(start, length);
+
+        // Clear the run we just handled.
+        auto run = (length == 64) ? ~std::uint64_t{0} :
+            ((std::uint64_t{1} << length) - 1);
+        mask &= ~(run << start);
+    }
+}
+
+// Same as strip(text, delim): collapses every run of delimiters into its
+// first character.
+template <typename Delim = char>
+std::string stripFast(std::string_view text, Delim const& delim = ' ')
+{
+    // Leave some slack at the end so short runs can always be copied with a
+    // single fixed-size copy, which is much cheaper than an exact one.
+    constexpr std::size_t slack{16};
+    std::string result(text.size() + slack, '\0');
+    auto out = result.data();
+    std::uint64_t carry{0};
+    scanBlocks(text, delim,
+            [&](std::size_t offset, std::uint64_t delims, std::uint64_t valid)
+            {
+                forEachRun(stripMask(delims, valid, carry),
+                        [&](std::size_t start, std::size_t length)
+                        {
+                            auto src = text.data() + offset + start;
+                            if (length <= slack &&
+                                    offset + start + slack <= text.size())
+                            {
+                                std::memcpy(out, src, slack);
+                            }
+                            else
+                            {
+                                std::memcpy(out, src, length);
+                            }
+                            out += length;
+                        });
+            });
+
+    result.resize(static_cast<std::size_t>(out - result.data()));
+    return result;
+}
+
+// Same as split(text, words, delim), but splits on any of a set of
+// delimiters.
+inline void split(std::string_view text, std::vector<std::string_view>& words,
+        DelimiterSet const& delims)
+{
+    words.clear();
+    forEachWord(text, delims,
+            [&words](std::string_view word) { words.push_back(word); });
+}
@@ -0,0 +1,135 @@
+#include "../../week_5/code/Timer.hpp"
+#include "intscan.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+// The countLessThan and findLessThan from search.cpp.
+int countLessThan(std::vector<int> const& vec, int elem)
+{
+    int count{0};
+    for (auto num : vec)
+    {
+        if (num < elem)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+std::vector<int> findLessThan(std::vector<int> const& vec, int elem)
+{
+    std::vector<int> result;
+    for (auto num : vec)
+    {
+        if (num < elem)
+        {
+            result.push_back(num);
+        }
+    }
+
+    return result;
+}
+
+bool sameResults(std::vector<int> const& vec, int elem)
+{
+    return countLessThanFast(vec, elem) ==
+        static_cast<std::size_t>(countLessThan(vec, elem)) &&
+        findLessThanFast(vec, elem) == findLessThan(vec, elem);
+}
+
+// Times each version with a limit that selects every percentage of the
+// values, from none of them to all of them.
+void benchmark(std::string const& name, std::vector<int> const& values,
+        int maxValue)
+{
+    Timer<std::chrono::microseconds> timer;
+    auto report = [&values](std::string const& what, long long us)
+    {
+        std::cout << " " << what << " " <<
+            static_cast<double>(values.size()) * 1.0e-3 / us << " G/s";
+    };
+
+    std::cout << name << " (elements per second)" << std::endl;
+
+    // findLessThanFast writes to a buffer we allocate (and touch) once.
+    std::vector<int> buffer(values.size() + FindSlack);
+    for (int percent : {0, 1, 10, 25, 50, 75, 90, 99, 100})
+    {
+        auto limit = static_cast<int>(
+                static_cast<long long>(maxValue) * percent / 100);
+        std::size_t check{0};
+        std::cout << percent << "%:";
+
+        timer.start();
+        check += static_cast<std::size_t>(countLessThan(values, limit));
+        report("count", timer.elapsed().count());
+
+        timer.start();
+        check -= countLessThanFast(values, limit);
+        report("countFast", timer.elapsed().count());
+
+        timer.start();
+        check += findLessThan(values, limit).size();
+        report("find", timer.elapsed().count());
+
+        timer.start();
+        check -= findLessThanFast(values, limit, buffer.data());
+        report("findFast", timer.elapsed().count());
+
+        std::cout << (check == 0 ? "" : " MISMATCH") << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // Corner cases first: every length around a register, and limits at the
+    // ends of the range.
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> small{-5, 5};
+    for (std::size_t size = 0; size < 70; ++size)
+    {
+        std::vector<int> values(size);
+        for (auto& value : values)
+        {
+            value = small(gen);
+        }
+
+        for (int limit : {-6, -1, 0, 3, 6, std::numeric_limits<int>::min(),
+                std::numeric_limits<int>::max()})
+        {
+            if (!sameResults(values, limit))
+            {
+                std::cout << "Mismatch for " << size << " values below " <<
+                    limit << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // The number of values in millions can be given on the command line.
+    std::size_t millions = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) :
+        64;
+    constexpr int maxValue{1000000000};
+    std::uniform_int_distribution<int> value{0, maxValue - 1};
+    std::vector<int> values(millions * 1000000);
+    for (auto& v : values)
+    {
+        v = value(gen);
+    }
+
+    benchmark("Random", values, maxValue);
+    std::sort(values.begin(), values.end());
+    benchmark("Sorted", values, maxValue);
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Vectorized versions of countLessThan and findLessThan from search.cpp.
+//
+// The loops in search.cpp branch on every element. When the data is random
+// that branch is a coin toss, and every mispredicted element costs more than
+// the comparison itself. Here a whole register of elements is compared at
+// once, which gives a mask with one bit per element, and we never branch on
+// the result:
+//
+// - Counting adds up the popcount of the masks.
+// - Finding is a stream compaction: the mask picks a shuffle that moves the
+//   matching elements to the front of the register, the whole register is
+//   stored, and the output only moves ahead by the number of matches. The
+//   elements past those are overwritten by the next store.
+//
+// Compile with -mavx2 (or -march=native) to use AVX2, and with AVX-512 the
+// compaction is a single instruction. Otherwise SSE2 is used on x86-64 for
+// counting, and branchless loops everywhere else.
+
+// Returns how many elements of vec are less than elem.
+inline std::size_t countLessThanFast(std::vector<int> const& vec, int elem)
+{
+    auto data = vec.data();
+    auto size = vec.size();
+    std::size_t count{0};
+    std::size_t i{0};
+
+#if defined(__AVX2__)
+    // Four registers at a time, so their masks fill one 32-bit popcount.
+    auto limit = _mm256_set1_epi32(elem);
+    auto mask = [&](std::size_t offset)
+    {
+        auto values = _mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(data + offset));
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(
+                    _mm256_castsi256_ps(_mm256_cmpgt_epi32(limit, values))));
+    };
+
+    for (; i + 32 <= size; i += 32)
+    {
+        auto bits = mask(i) | (mask(i + 8) << 8) | (mask(i + 16) << 16) |
+            (mask(i + 24) << 24);
+        count += static_cast<std::size_t>(__builtin_popcount(bits));
+    }
+#elif defined(__SSE2__)
+    auto limit = _mm_set1_epi32(elem);
+    auto mask = [&](std::size_t offset)
+    {
+        auto values = _mm_loadu_si128(
+                reinterpret_cast<__m128i const*>(data + offset));
+        return static_cast<std::uint32_t>(_mm_movemask_ps(
+                    _mm_castsi128_ps(_mm_cmplt_epi32(values, limit))));
+    };
+
+    for (; i + 16 <= size; i += 16)
+    {
+        auto bits = mask(i) | (mask(i + 4) << 4) | (mask(i + 8) << 8) |
+            (mask(i + 12) << 12);
+        count += static_cast<std::size_t>(__builtin_popcount(bits));
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        count += data[i] < elem;
+    }
+
+    return count;
+}
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+// For every 8-bit mask, the indices of its set bits in order, followed by
+// zeros. Permuting a register with them moves the selected elements to the
+// front.
+constexpr std::array<std::array<std::uint32_t, 8>, 256> makeCompressTable()
+{
+    std::array<std::array<std::uint32_t, 8>, 256> table{};
+    for (std::size_t mask = 0; mask < 256; ++mask)
+    {
+        std::size_t count{0};
+        for (std::uint32_t bit = 0; bit < 8; ++bit)
+        {
+            if ((mask >> bit) & 1)
+            {
+                table[mask][count++] = bit;
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr auto compressTable = makeCompressTable();
+#endif
+
+// The number of elements past the end of the matches that findLessThanFast
+// may write to.
+constexpr std::size_t FindSlack{16};
+
+// Writes the elements of vec that are less than elem to out, in order, and
+// returns how many there are. out must have room for vec.size() + FindSlack
+// elements, since whole registers are stored.
+inline std::size_t findLessThanFast(std::vector<int> const& vec, int elem,
+        int* out)
+{
+    auto data = vec.data();
+    auto size = vec.size();
+    auto start = out;
+    std::size_t i{0};
+
+#if defined(__AVX512F__)
+    auto limit = _mm512_set1_epi32(elem);
+    for (; i + 16 <= size; i += 16)
+    {
+        auto values = _mm512_loadu_si512(data + i);
+        auto mask = _mm512_cmplt_epi32_mask(values, limit);
+        _mm512_storeu_si512(out, _mm512_maskz_compress_epi32(mask, values));
+        out += __builtin_popcount(mask);
+    }
+#elif defined(__AVX2__)
+    auto limit = _mm256_set1_epi32(elem);
+    for (; i + 8 <= size; i += 8)
+    {
+        auto values = _mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(data + i));
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_ps(
+                    _mm256_castsi256_ps(_mm256_cmpgt_epi32(limit, values))));
+        auto indices = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(
+                    compressTable[mask].data()));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                _mm256_permutevar8x32_epi32(values, indices));
+        out += __builtin_popcount(mask);
+    }
+#endif
+
+    // Always write the element, and only keep it if it matches.
+    for (; i < size; ++i)
+    {
+        *out = data[i];
+        out += data[i] < elem;
+    }
+
+    return static_cast<std::size_t>(out - start);
+}
+
+// The same, returning a vector. It is sized for the worst case up front and
+// cut down at the end, so nothing is reallocated along the way (but it does
+// have to be filled with zeros first; reuse a buffer with the version above
+// to avoid that).
+inline std::vector<int> findLessThanFast(std::vector<int> const& vec,
+        int elem)
+{
+    std::vector<int> result(vec.size() + FindSlack);
+    result.resize(findLessThanFast(vec, elem, result.data()));
+    return result;
+}
@@ -0,0 +1,309 @@
+#include "../../week_5/code/Timer.hpp"
+#include "ranktree.hpp"
+#include "intscan.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <set>
+#include <random>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+// The values are random, and so are the updates: every update erases a value
+// that is in the data and inserts a new one, so the size stays the same.
+// Between updates we ask countLessThan for a random value.
+struct Workload
+{
+    std::vector<int> initial;
+    std::vector<std::size_t> erasePositions;
+    std::vector<int> inserts;
+    std::vector<int> queries;
+    std::size_t updatesPerQuery;
+};
+
+Workload makeWorkload(std::size_t size, std::size_t numQueries,
+        std::size_t updatesPerQuery)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> value{0, 1000000000};
+    std::uniform_int_distribution<std::size_t> position{0, size - 1};
+
+    Workload work;
+    work.updatesPerQuery = updatesPerQuery;
+    work.initial.resize(size);
+    for (auto& v : work.initial)
+    {
+        v = value(gen);
+    }
+    for (std::size_t i = 0; i < numQueries * updatesPerQuery; ++i)
+    {
+        work.erasePositions.push_back(position(gen));
+        work.inserts.push_back(value(gen));
+    }
+    for (std::size_t i = 0; i < numQueries; ++i)
+    {
+        work.queries.push_back(value(gen));
+    }
+    return work;
+}
+
+// Each version runs the first numQueries queries, with their updates, on
+// state that was set up before the timer started, and returns the answers.
+
+// Keeps the values in a plain vector, which is cheap to update, and counts
+// with a full scan every time.
+std::vector<std::size_t> runScan(Workload const& work, std::size_t numQueries,
+        std::vector<int>& values)
+{
+    std::vector<std::size_t> answers(numQueries);
+    std::size_t update{0};
+    for (std::size_t q = 0; q < numQueries; ++q)
+    {
+        for (std::size_t u = 0; u < work.updatesPerQuery; ++u, ++update)
+        {
+            values[work.erasePositions[update]] = work.inserts[update];
+        }
+        answers[q] = countLessThanFast(values, work.queries[q]);
+    }
+    return answers;
+}
+
+// Sorts the values again whenever they have changed, and counts with a
+// binary search.
+std::vector<std::size_t> runResort(Workload const& work,
+        std::size_t numQueries, std::vector<int>& values,
+        std::vector<int>& sorted)
+{
+    std::vector<std::size_t> answers(numQueries);
+    std::size_t update{0};
+    for (std::size_t q = 0; q < numQueries; ++q)
+    {
+        for (std::size_t u = 0; u < work.updatesPerQuery; ++u, ++update)
+        {
+            values[work.erasePositions[update]] = work.inserts[update];
+        }
+        if (work.updatesPerQuery > 0)
+        {
+            sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+        }
+        answers[q] = static_cast<std::size_t>(std::lower_bound(sorted.begin(),
+                    sorted.end(), work.queries[q]) - sorted.begin());
+    }
+    return answers;
+}
+
+// The tree doesn't know positions, so values tells it which value to erase.
+std::vector<std::size_t> runTree(Workload const& work, std::size_t numQueries,
+        std::vector<int>& values, RankTree& tree)
+{
+    std::vector<std::size_t> answers(numQueries);
+    std::size_t update{0};
+    for (std::size_t q = 0; q < numQueries; ++q)
+    {
+        for (std::size_t u = 0; u < work.updatesPerQuery; ++u, ++update)
+        {
+            auto& slot = values[work.erasePositions[update]];
+            tree.erase(slot);
+            slot = work.inserts[update];
+            tree.insert(slot);
+        }
+        answers[q] = tree.rank(work.queries[q]);
+    }
+    return answers;
+}
+
+// Compares every rank and select of the tree against a std::multiset holding
+// the same values.
+bool sameAs(RankTree const& tree, std::multiset<int> const& expected)
+{
+    std::vector<int> values(expected.begin(), expected.end());
+    if (tree.size() != values.size() || tree.empty() != values.empty() ||
+            !std::equal(tree.begin(), tree.end(), values.begin(),
+                values.end()))
+    {
+        return false;
+    }
+
+    for (std::size_t k = 0; k < values.size(); ++k)
+    {
+        auto rank = static_cast<std::size_t>(std::lower_bound(values.begin(),
+                    values.end(), values[k]) - values.begin());
+        if (tree.select(k) != values[k] || tree.rank(values[k]) != rank ||
+                tree.rank(values[k] + 1) != static_cast<std::size_t>(
+                    std::upper_bound(values.begin(), values.end(),
+                        values[k]) - values.begin()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Grows a tree a few levels deep with many duplicates, erases values that
+// are there and values that aren't, and then shrinks it down to nothing, so
+// that merges run all the way up to the root. Along the way it is compared
+// with a std::multiset.
+bool checkTree()
+{
+    std::mt19937 gen{45};
+    std::uniform_int_distribution<int> value{0, 20000};
+    std::vector<int> initial(50000);
+    for (auto& v : initial)
+    {
+        v = value(gen);
+    }
+
+    RankTree tree{initial};
+    std::multiset<int> expected(initial.begin(), initial.end());
+    for (std::size_t i = 0; i < 100000; ++i)
+    {
+        auto v = value(gen);
+        if (i % 3 == 0)
+        {
+            tree.insert(v);
+            expected.insert(v);
+        }
+        else
+        {
+            auto it = expected.find(v);
+            if (tree.erase(v) != (it != expected.end()))
+            {
+                std::cout << "erase(" << v << ") got it wrong" << std::endl;
+                return false;
+            }
+            if (it != expected.end())
+            {
+                expected.erase(it);
+            }
+        }
+
+        if (i % 10000 == 0 && !sameAs(tree, expected))
+        {
+            return false;
+        }
+    }
+
+    // Erase what is left in random order, until the tree is empty.
+    std::vector<int> rest(expected.begin(), expected.end());
+    std::shuffle(rest.begin(), rest.end(), gen);
+    for (std::size_t i = 0; i < rest.size(); ++i)
+    {
+        if (!tree.erase(rest[i]))
+        {
+            std::cout << "erase(" << rest[i] << ") lost a value" << std::endl;
+            return false;
+        }
+        expected.erase(expected.find(rest[i]));
+        if ((i % 5000 == 0 || expected.size() < 100) &&
+                !sameAs(tree, expected))
+        {
+            return false;
+        }
+    }
+
+    // The empty tree must still work.
+    if (tree.erase(1) || tree.rank(1) != 0 || tree.begin() != tree.end())
+    {
+        return false;
+    }
+    for (auto v : {3, 1, 2, 1})
+    {
+        tree.insert(v);
+        expected.insert(v);
+    }
+    return sameAs(tree, expected);
+}
+
+int main(int argc, char* argv[])
+{
+    if (!checkTree())
+    {
+        std::cout << "RankTree is broken!" << std::endl;
+        return 1;
+    }
+
+    // The number of values in millions can be given on the command line.
+    std::size_t millions = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) :
+        1;
+    auto size = millions * 1000000;
+    Timer<std::chrono::milliseconds> timer;
+
+    // Building the tree in one go against inserting every value.
+    {
+        auto work = makeWorkload(size, 0, 0);
+        timer.start();
+        RankTree built{work.initial};
+        std::cout << "Build " << size << " values: " <<
+            timer.elapsed().count() << " ms";
+
+        timer.start();
+        RankTree inserted;
+        for (auto value : work.initial)
+        {
+            inserted.insert(value);
+        }
+        std::cout << ", inserting them one by one: " <<
+            timer.elapsed().count() << " ms" << std::endl;
+
+        // findLessThan is a range over the tree.
+        auto limit = 10000000;
+        std::vector<int> expected;
+        for (auto value : built.lessThan(limit))
+        {
+            expected.push_back(value);
+        }
+        auto found = findLessThanFast(work.initial, limit);
+        std::sort(found.begin(), found.end());
+        if (found != expected ||
+                !std::equal(built.begin(), built.end(), inserted.begin(),
+                    inserted.end()))
+        {
+            std::cout << "The trees differ!" << std::endl;
+            return 1;
+        }
+    }
+
+    // Sorting everything again takes as long as thousands of scans, so it
+    // gets fewer queries. Times are per query, updates included.
+    Timer<std::chrono::microseconds> usTimer;
+    auto report = [](std::string const& what, long long us, std::size_t n)
+    {
+        std::cout << " " << what << " " << static_cast<double>(us) /
+            static_cast<double>(n) << " us";
+    };
+    for (std::size_t updatesPerQuery : {0, 1, 10, 100})
+    {
+        std::size_t numQueries{1000};
+        std::size_t resortQueries{updatesPerQuery == 0 ? numQueries : 10};
+        auto work = makeWorkload(size, numQueries, updatesPerQuery);
+        std::cout << updatesPerQuery << " updates per query:";
+
+        auto values = work.initial;
+        usTimer.start();
+        auto scan = runScan(work, numQueries, values);
+        report("scan", usTimer.elapsed().count(), numQueries);
+
+        values = work.initial;
+        auto sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        usTimer.start();
+        auto resort = runResort(work, resortQueries, values, sorted);
+        report("sort again", usTimer.elapsed().count(), resortQueries);
+
+        values = work.initial;
+        RankTree tree{values};
+        usTimer.start();
+        auto ranks = runTree(work, numQueries, values, tree);
+        report("RankTree", usTimer.elapsed().count(), numQueries);
+
+        auto same = scan == ranks && std::equal(resort.begin(), resort.end(),
+                scan.begin());
+        std::cout << (same ? "" : " MISMATCH") << std::endl;
+    }
+
+    return 0;
+}
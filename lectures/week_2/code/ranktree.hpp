@@ -0,0 +1,685 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// A sorted multiset of ints that answers countLessThan (the rank of a value)
+// and its inverse (the value at a rank) in O(log n), and stays that way as
+// values are inserted and erased.
+//
+// It is a B+ tree: the values live in sorted leaves of up to LeafCapacity
+// values, which are linked so they can be walked in order, and every inner
+// node keeps the number of values below each of its children. Rank then adds
+// up the counts of the children to the left of the path down to the value,
+// and select follows the counts down to the k-th value.
+//
+// Nodes are kept in two vectors and refer to each other by index, and nodes
+// freed by merges are reused. A node that falls below a quarter full is merged
+// with a sibling, or takes some of its sibling's entries if they don't fit
+// together, so the tree stays balanced however values come and go.
+class RankTree
+{
+private:
+    static constexpr std::uint32_t None{~std::uint32_t{0}};
+
+public:
+    // Walks the values in order.
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = int const*;
+        using reference = int const&;
+
+        Iterator() = default;
+
+        int const& operator*() const
+        {
+            return mTree->mLeaves[mLeaf].values[mPos];
+        }
+
+        Iterator& operator++()
+        {
+            if (++mPos == mTree->mLeaves[mLeaf].size)
+            {
+                mLeaf = mTree->mLeaves[mLeaf].next;
+                mPos = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(Iterator const& other) const
+        {
+            return mLeaf == other.mLeaf && mPos == other.mPos;
+        }
+
+        bool operator!=(Iterator const& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        friend class RankTree;
+
+        Iterator(RankTree const* tree, std::uint32_t leaf, std::uint32_t pos) :
+            mTree{tree},
+            mLeaf{leaf},
+            mPos{pos}
+        {
+            // The end of a leaf is the start of the next one.
+            if (mLeaf != None && mPos == mTree->mLeaves[mLeaf].size)
+            {
+                mLeaf = mTree->mLeaves[mLeaf].next;
+                mPos = 0;
+            }
+        }
+
+        RankTree const* mTree{nullptr};
+        std::uint32_t mLeaf{None};
+        std::uint32_t mPos{0};
+    };
+
+    // A pair of iterators that can be used in a range-based for loop.
+    struct Range
+    {
+        Iterator first;
+        Iterator last;
+
+        Iterator begin() const
+        {
+            return first;
+        }
+
+        Iterator end() const
+        {
+            return last;
+        }
+    };
+
+    RankTree()
+    {
+        clear();
+    }
+
+    // Builds the tree from the values all at once, which is much faster than
+    // inserting them one by one: they are sorted and cut into leaves that are
+    // three quarters full, and the inner nodes are built on top of those a
+    // level at a time.
+    explicit RankTree(std::vector<int> values)
+    {
+        clear();
+        if (values.empty())
+        {
+            return;
+        }
+
+        std::sort(values.begin(), values.end());
+        mSize = values.size();
+        mLeaves.clear();
+
+        std::vector<Entry> level;
+        auto numLeaves = pieces(values.size(), LeafCapacity);
+        for (std::size_t i = 0; i < numLeaves; ++i)
+        {
+            auto first = values.size() * i / numLeaves;
+            auto last = values.size() * (i + 1) / numLeaves;
+            auto leaf = newLeaf();
+            auto& node = mLeaves[leaf];
+            std::copy(values.begin() + static_cast<std::ptrdiff_t>(first),
+                    values.begin() + static_cast<std::ptrdiff_t>(last),
+                    node.values.begin());
+            node.size = static_cast<std::uint32_t>(last - first);
+            node.prev = (i == 0) ? None : leaf - 1;
+            node.next = (i + 1 == numLeaves) ? None : leaf + 1;
+            level.push_back({leaf, node.size, node.values[0]});
+        }
+
+        mHeight = 0;
+        while (level.size() > 1)
+        {
+            std::vector<Entry> parents;
+            auto numInners = pieces(level.size(), InnerCapacity);
+            for (std::size_t i = 0; i < numInners; ++i)
+            {
+                auto first = level.size() * i / numInners;
+                auto last = level.size() * (i + 1) / numInners;
+                auto inner = newInner();
+                auto& node = mInners[inner];
+                for (auto j = first; j < last; ++j)
+                {
+                    node.append(level[j]);
+                }
+                parents.push_back({inner, node.total, node.mins[0]});
+            }
+
+            level = std::move(parents);
+            ++mHeight;
+        }
+        mRoot = level[0].node;
+    }
+
+    void clear()
+    {
+        mLeaves.clear();
+        mInners.clear();
+        mFreeLeaves.clear();
+        mFreeInners.clear();
+        mRoot = newLeaf();
+        mHeight = 0;
+        mSize = 0;
+    }
+
+    std::size_t size() const
+    {
+        return mSize;
+    }
+
+    bool empty() const
+    {
+        return mSize == 0;
+    }
+
+    void insert(int value)
+    {
+        auto split = insert(mRoot, mHeight, value);
+        if (split != None)
+        {
+            // The root split, so the tree grows a level.
+            auto root = newInner();
+            mInners[root].append(entry(mRoot, mHeight));
+            mInners[root].append(entry(split, mHeight));
+            mRoot = root;
+            ++mHeight;
+        }
+        ++mSize;
+    }
+
+    // Removes one copy of the value. Returns false if there is none.
+    bool erase(int value)
+    {
+        if (!erase(mRoot, mHeight, value))
+        {
+            return false;
+        }
+
+        // A root with a single child isn't needed any more.
+        while (mHeight > 0 && mInners[mRoot].size == 1)
+        {
+            auto child = mInners[mRoot].children[0];
+            freeInner(mRoot);
+            mRoot = child;
+            --mHeight;
+        }
+        --mSize;
+        return true;
+    }
+
+    // The number of values less than value, which is countLessThan.
+    std::size_t rank(int value) const
+    {
+        std::size_t rank{0};
+        auto node = mRoot;
+        for (auto level = mHeight; level > 0; --level)
+        {
+            auto const& inner = mInners[node];
+            auto i = lowerChild(inner, value);
+            for (std::uint32_t j = 0; j < i; ++j)
+            {
+                rank += inner.counts[j];
+            }
+            node = inner.children[i];
+        }
+
+        auto const& leaf = mLeaves[node];
+        return rank + static_cast<std::size_t>(std::lower_bound(
+                    leaf.values.begin(), leaf.values.begin() + leaf.size,
+                    value) - leaf.values.begin());
+    }
+
+    // The value with k values before it (k must be less than size()).
+    int select(std::size_t k) const
+    {
+        auto node = mRoot;
+        for (auto level = mHeight; level > 0; --level)
+        {
+            auto const& inner = mInners[node];
+            std::uint32_t i{0};
+            while (k >= inner.counts[i])
+            {
+                k -= inner.counts[i];
+                ++i;
+            }
+            node = inner.children[i];
+        }
+
+        return mLeaves[node].values[k];
+    }
+
+    Iterator begin() const
+    {
+        auto node = mRoot;
+        for (auto level = mHeight; level > 0; --level)
+        {
+            node = mInners[node].children[0];
+        }
+        return {this, node, 0};
+    }
+
+    Iterator end() const
+    {
+        return {};
+    }
+
+    // The first value that is not less than value.
+    Iterator lowerBound(int value) const
+    {
+        auto node = mRoot;
+        for (auto level = mHeight; level > 0; --level)
+        {
+            auto const& inner = mInners[node];
+            node = inner.children[lowerChild(inner, value)];
+        }
+
+        auto const& leaf = mLeaves[node];
+        auto pos = std::lower_bound(leaf.values.begin(),
+                leaf.values.begin() + leaf.size, value) - leaf.values.begin();
+        return {this, node, static_cast<std::uint32_t>(pos)};
+    }
+
+    // The values less than value, in order, which is findLessThan.
+    Range lessThan(int value) const
+    {
+        return {begin(), lowerBound(value)};
+    }
+
+private:
+    static constexpr std::uint32_t LeafCapacity{64};
+    static constexpr std::uint32_t InnerCapacity{32};
+
+    // A child as seen from its parent.
+    struct Entry
+    {
+        std::uint32_t node;
+        std::size_t count;
+        int min;
+    };
+
+    struct Leaf
+    {
+        std::uint32_t size{0};
+        std::uint32_t prev{None};
+        std::uint32_t next{None};
+        std::array<int, LeafCapacity> values;
+    };
+
+    // mins[i] is the smallest value below children[i], which is what we
+    // search on, and counts[i] how many values there are below it.
+    struct Inner
+    {
+        std::uint32_t size{0};
+        std::size_t total{0};
+        std::array<std::uint32_t, InnerCapacity> children;
+        std::array<std::size_t, InnerCapacity> counts;
+        std::array<int, InnerCapacity> mins;
+
+        void append(Entry const& entry)
+        {
+            insert(size, entry);
+        }
+
+        void insert(std::uint32_t i, Entry const& entry)
+        {
+            for (auto j = size; j > i; --j)
+            {
+                children[j] = children[j - 1];
+                counts[j] = counts[j - 1];
+                mins[j] = mins[j - 1];
+            }
+            children[i] = entry.node;
+            counts[i] = entry.count;
+            mins[i] = entry.min;
+            total += entry.count;
+            ++size;
+        }
+
+        void remove(std::uint32_t i)
+        {
+            total -= counts[i];
+            for (auto j = i + 1; j < size; ++j)
+            {
+                children[j - 1] = children[j];
+                counts[j - 1] = counts[j];
+                mins[j - 1] = mins[j];
+            }
+            --size;
+        }
+    };
+
+    // How many nodes to cut count entries into so that each is about three
+    // quarters full.
+    static std::size_t pieces(std::size_t count, std::size_t capacity)
+    {
+        auto fill = capacity * 3 / 4;
+        return std::max<std::size_t>((count + fill - 1) / fill, 1);
+    }
+
+    // The last child whose values can all be less than value, which is where
+    // the first copy of value would be. Children before it only hold smaller
+    // values, and children after it only larger or equal ones.
+    static std::uint32_t lowerChild(Inner const& inner, int value)
+    {
+        std::uint32_t i{0};
+        while (i + 1 < inner.size && inner.mins[i + 1] < value)
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    // The last child whose smallest value is at most value. If the value is
+    // in the tree, a copy of it is below that child.
+    static std::uint32_t upperChild(Inner const& inner, int value)
+    {
+        std::uint32_t i{0};
+        while (i + 1 < inner.size && inner.mins[i + 1] <= value)
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    Entry entry(std::uint32_t node, std::size_t level) const
+    {
+        if (level == 0)
+        {
+            auto const& leaf = mLeaves[node];
+            return {node, leaf.size, leaf.values[0]};
+        }
+
+        auto const& inner = mInners[node];
+        return {node, inner.total, inner.mins[0]};
+    }
+
+    // Inserts the value below node, which is at the given height. Returns the
+    // node's new right sibling if it had to split, or None.
+    std::uint32_t insert(std::uint32_t node, std::size_t level, int value)
+    {
+        if (level == 0)
+        {
+            auto split = None;
+            if (mLeaves[node].size == LeafCapacity)
+            {
+                split = splitLeaf(node);
+                if (value >= mLeaves[split].values[0])
+                {
+                    node = split;
+                }
+            }
+
+            auto& leaf = mLeaves[node];
+            auto pos = std::upper_bound(leaf.values.begin(),
+                    leaf.values.begin() + leaf.size, value);
+            std::copy_backward(pos, leaf.values.begin() + leaf.size,
+                    leaf.values.begin() + leaf.size + 1);
+            *pos = value;
+            ++leaf.size;
+            return split;
+        }
+
+        auto i = upperChild(mInners[node], value);
+        auto child = mInners[node].children[i];
+        auto childSplit = insert(child, level - 1, value);
+
+        // The child may have split, so it is counted again from scratch.
+        auto& inner = mInners[node];
+        inner.total -= inner.counts[i];
+        auto updated = entry(child, level - 1);
+        inner.counts[i] = updated.count;
+        inner.mins[i] = updated.min;
+        inner.total += updated.count;
+        if (childSplit == None)
+        {
+            return None;
+        }
+
+        auto split = None;
+        auto pos = i + 1;
+        if (inner.size == InnerCapacity)
+        {
+            split = splitInner(node);
+            if (pos > mInners[node].size)
+            {
+                pos -= mInners[node].size;
+                node = split;
+            }
+        }
+        mInners[node].insert(pos, entry(childSplit, level - 1));
+        return split;
+    }
+
+    // Moves the upper half of a full leaf to a new leaf after it.
+    std::uint32_t splitLeaf(std::uint32_t node)
+    {
+        auto split = newLeaf();
+        auto& leaf = mLeaves[node];
+        auto& right = mLeaves[split];
+        auto half = leaf.size / 2;
+        std::copy(leaf.values.begin() + half, leaf.values.begin() + leaf.size,
+                right.values.begin());
+        right.size = leaf.size - half;
+        leaf.size = half;
+
+        right.prev = node;
+        right.next = leaf.next;
+        if (leaf.next != None)
+        {
+            mLeaves[leaf.next].prev = split;
+        }
+        leaf.next = split;
+        return split;
+    }
+
+    // Moves the upper half of a full inner node to a new node after it.
+    std::uint32_t splitInner(std::uint32_t node)
+    {
+        auto split = newInner();
+        auto& inner = mInners[node];
+        auto& right = mInners[split];
+        auto half = inner.size / 2;
+        for (auto j = half; j < inner.size; ++j)
+        {
+            right.append({inner.children[j], inner.counts[j], inner.mins[j]});
+        }
+        while (inner.size > half)
+        {
+            inner.remove(inner.size - 1);
+        }
+        return split;
+    }
+
+    // Erases one copy of the value below node. Returns false if there was
+    // none.
+    bool erase(std::uint32_t node, std::size_t level, int value)
+    {
+        if (level == 0)
+        {
+            auto& leaf = mLeaves[node];
+            auto last = leaf.values.begin() + leaf.size;
+            auto pos = std::lower_bound(leaf.values.begin(), last, value);
+            if (pos == last || *pos != value)
+            {
+                return false;
+            }
+            std::copy(pos + 1, last, pos);
+            --leaf.size;
+            return true;
+        }
+
+        auto i = upperChild(mInners[node], value);
+        auto child = mInners[node].children[i];
+        if (!erase(child, level - 1, value))
+        {
+            return false;
+        }
+
+        auto& inner = mInners[node];
+        --inner.counts[i];
+        --inner.total;
+        auto underfull = (level == 1) ?
+            mLeaves[child].size < LeafCapacity / 4 :
+            mInners[child].size < InnerCapacity / 4;
+        if (underfull && inner.size > 1)
+        {
+            rebalance(node, i, level - 1);
+        }
+        else if (inner.counts[i] > 0)
+        {
+            inner.mins[i] = entry(child, level - 1).min;
+        }
+        return true;
+    }
+
+    // Fixes up children[i] of node, which has fallen below a quarter full,
+    // together with one of its siblings: they are merged if they fit in one
+    // node, and otherwise share their entries evenly.
+    void rebalance(std::uint32_t node, std::uint32_t i, std::size_t level)
+    {
+        auto left = (i + 1 < mInners[node].size) ? i : i - 1;
+        auto a = mInners[node].children[left];
+        auto b = mInners[node].children[left + 1];
+
+        bool merged = (level == 0) ? balanceLeaves(a, b) :
+            balanceInners(a, b);
+        auto& inner = mInners[node];
+        inner.remove(left + 1);
+        if (!merged)
+        {
+            inner.insert(left + 1, entry(b, level));
+        }
+        inner.remove(left);
+        inner.insert(left, entry(a, level));
+    }
+
+    // Returns true if b was merged into a (and freed).
+    bool balanceLeaves(std::uint32_t a, std::uint32_t b)
+    {
+        auto& left = mLeaves[a];
+        auto& right = mLeaves[b];
+        auto total = left.size + right.size;
+        if (total <= LeafCapacity)
+        {
+            std::copy(right.values.begin(), right.values.begin() + right.size,
+                    left.values.begin() + left.size);
+            left.size = total;
+            left.next = right.next;
+            if (right.next != None)
+            {
+                mLeaves[right.next].prev = a;
+            }
+            freeLeaf(b);
+            return true;
+        }
+
+        // Concatenate, then cut in the middle.
+        std::array<int, 2 * LeafCapacity> values;
+        std::copy(left.values.begin(), left.values.begin() + left.size,
+                values.begin());
+        std::copy(right.values.begin(), right.values.begin() + right.size,
+                values.begin() + left.size);
+        left.size = total / 2;
+        right.size = total - left.size;
+        std::copy(values.begin(), values.begin() + left.size,
+                left.values.begin());
+        std::copy(values.begin() + left.size, values.begin() + total,
+                right.values.begin());
+        return false;
+    }
+
+    bool balanceInners(std::uint32_t a, std::uint32_t b)
+    {
+        auto& left = mInners[a];
+        auto& right = mInners[b];
+        std::array<Entry, 2 * InnerCapacity> entries;
+        std::uint32_t total{0};
+        for (auto const* node : {&left, &right})
+        {
+            for (std::uint32_t j = 0; j < node->size; ++j)
+            {
+                entries[total++] = {node->children[j], node->counts[j],
+                    node->mins[j]};
+            }
+        }
+
+        left = Inner{};
+        right = Inner{};
+        auto merged = total <= InnerCapacity;
+        auto half = merged ? total : total / 2;
+        for (std::uint32_t j = 0; j < total; ++j)
+        {
+            (j < half ? left : right).append(entries[j]);
+        }
+
+        if (merged)
+        {
+            freeInner(b);
+        }
+        return merged;
+    }
+
+    std::uint32_t newLeaf()
+    {
+        if (!mFreeLeaves.empty())
+        {
+            auto leaf = mFreeLeaves.back();
+            mFreeLeaves.pop_back();
+            mLeaves[leaf] = Leaf{};
+            return leaf;
+        }
+        mLeaves.emplace_back();
+        return static_cast<std::uint32_t>(mLeaves.size() - 1);
+    }
+
+    std::uint32_t newInner()
+    {
+        if (!mFreeInners.empty())
+        {
+            auto inner = mFreeInners.back();
+            mFreeInners.pop_back();
+            mInners[inner] = Inner{};
+            return inner;
+        }
+        mInners.emplace_back();
+        return static_cast<std::uint32_t>(mInners.size() - 1);
+    }
+
+    void freeLeaf(std::uint32_t leaf)
+    {
+        mFreeLeaves.push_back(leaf);
+    }
+
+    void freeInner(std::uint32_t inner)
+    {
+        mFreeInners.push_back(inner);
+    }
+
+    std::vector<Leaf> mLeaves;
+    std::vector<Inner> mInners;
+    std::vector<std::uint32_t> mFreeLeaves;
+    std::vector<std::uint32_t> mFreeInners;
+    std::uint32_t mRoot{None};
+    std::size_t mHeight{0};
+    std::size_t mSize{0};
+};
@@ -1,3 +1,5 @@
+#include "stripsplit.hpp"
+
 #include <iostream>
 #include <string>
 #include <vector>
@@ -72,6 +74,18 @@ int main()
         std::cout << word << std::endl;
     }
 
+    // The same thing in a single pass, without any intermediate strings.
+    // Tabs are treated as delimiters too.
+    std::string tabbed{"Yay  \t  it's \t\t Friday!"};
+    stripAndSplit(tabbed, " \t", [](std::string_view word)
+            {
+                std::cout << word << std::endl;
+            });
+
+    // If we really need the stripped text, we can strip in place.
+    stripInPlace(text);
+    std::cout << text << std::endl;
+
     return 0;
 
 }
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "delimiterset.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// split(strip(text)) reads the text twice and builds two copies of it along the
+// way. The functions below do the same work in a single pass, and accept a set
+// of delimiters instead of a single one: any run made up of characters from
+// delims counts as a single delimiter. The set is compiled into a lookup
+// table, so testing a character costs the same however many delimiters there
+// are.
+
+// Calls f(word) for every word in the text. The words point into the text, and
+// the corner cases match split(): leading delimiters give an empty first word,
+// trailing delimiters give nothing, and an empty text gives one empty word.
+template <typename UnaryFunction>
+void stripAndSplit(std::string_view text, DelimiterSet const& delims,
+        UnaryFunction f)
+{
+    bool isDelim{false};
+    std::size_t wordStart{0};
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+        bool delim = delims.contains(text[i]);
+
+        // The first delimiter of a run ends the current word.
+        if (delim && !isDelim)
+        {
+            f(text.substr(wordStart, i - wordStart));
+        }
+
+        // The first non-delimiter after a run starts a new one.
+        if (!delim && isDelim)
+        {
+            wordStart = i;
+        }
+
+        isDelim = delim;
+    }
+
+    if (!isDelim)
+    {
+        f(text.substr(wordStart));
+    }
+}
+
+template <typename UnaryFunction>
+void stripAndSplit(std::string_view text, std::string_view delims,
+        UnaryFunction f)
+{
+    stripAndSplit(text, DelimiterSet{delims}, f);
+}
+
+inline void stripAndSplit(std::string_view text,
+        std::vector<std::string_view>& words, std::string_view delims = " ")
+{
+    words.clear();
+    stripAndSplit(text, delims,
+            [&words](std::string_view word) { words.push_back(word); });
+}
+
+// Same as strip, but compacts the string in place instead of building a new
+// one. Each run of delimiters is replaced by its first character. Characters
+// are only written once they have to move, so a string with nothing to strip
+// is only read.
+inline void stripInPlace(std::string& text, std::string_view delims = " ")
+{
+    DelimiterSet set{delims};
+    bool isDelim{false};
+    std::size_t out{0};
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+        auto ch = text[i];
+        bool delim = set.contains(ch);
+        if (!delim || !isDelim)
+        {
+            if (out != i)
+            {
+                text[out] = ch;
+            }
+            ++out;
+        }
+
+        isDelim = delim;
+    }
+
+    text.resize(out);
+}
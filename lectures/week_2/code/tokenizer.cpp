@@ -0,0 +1,162 @@
+#include "../../week_5/code/Timer.hpp"
+#include "tokenizer.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+#include <new>
+
+using atlas::core::Timer;
+
+// Count every allocation so we can see how many each version makes.
+static std::size_t numAllocations{0};
+
+void* operator new(std::size_t size)
+{
+    ++numAllocations;
+    if (auto ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// The split from split.cpp.
+std::vector<std::string> split(std::string const& str, char delim = ' ')
+{
+    std::vector<std::string> words{};
+    std::string word{};
+    bool isSpace{false};
+    for (auto ch : str)
+    {
+        if (ch != delim)
+        {
+            isSpace = false;
+            word.push_back(ch);
+        }
+
+        if (ch == delim && !isSpace)
+        {
+            isSpace = true;
+            words.push_back(word);
+            word.clear();
+        }
+
+        if (ch == delim && isSpace)
+        {
+            continue;
+        }
+    }
+
+    if (!isSpace)
+    {
+        words.push_back(word);
+    }
+
+    return words;
+}
+
+bool sameWords(std::string const& text, char delim)
+{
+    auto expected = split(text, delim);
+    std::vector<std::string_view> words;
+    split(text, words, delim);
+
+    if (words.size() != expected.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        if (words[i] != expected[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string makeText(std::size_t size)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> length{1, 10};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::uniform_int_distribution<int> spaces{1, 3};
+
+    std::string text;
+    text.reserve(size + 16);
+    while (text.size() < size)
+    {
+        for (int i = length(gen); i > 0; --i)
+        {
+            text.push_back(static_cast<char>(letter(gen)));
+        }
+        text.append(spaces(gen), ' ');
+    }
+
+    return text;
+}
+
+int main()
+{
+    // The corner cases have to match split exactly.
+    std::vector<std::string> cases{"", " ", "   ", "a", " a", "a ", "  a  b  ",
+        "Some,random,,text", ",leading", "trailing,,", "Yay    it's  Friday!"};
+    for (auto const& text : cases)
+    {
+        if (!sameWords(text, ' ') || !sameWords(text, ','))
+        {
+            std::cout << "Mismatch on \"" << text << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    constexpr std::size_t size = 1 << 28;
+    constexpr std::size_t lineSize = 4096;
+    auto text = makeText(size);
+    Timer<std::chrono::milliseconds> timer;
+
+    // Feed the text to both versions one line at a time, like struct.cpp
+    // does.
+    std::size_t count{0};
+    auto before = numAllocations;
+    timer.start();
+    for (std::size_t i = 0; i < text.size(); i += lineSize)
+    {
+        std::string line = text.substr(i, lineSize);
+        count += split(line).size();
+    }
+    auto elapsed = timer.elapsed().count();
+    std::cout << "split:     " << count << " words, " << elapsed << " ms, " <<
+        numAllocations - before << " allocations" << std::endl;
+
+    count = 0;
+    std::vector<std::string_view> words;
+    std::string_view view{text};
+    before = numAllocations;
+    timer.start();
+    for (std::size_t i = 0; i < view.size(); i += lineSize)
+    {
+        split(view.substr(i, lineSize), words);
+        count += words.size();
+    }
+    elapsed = timer.elapsed().count();
+    std::cout << "tokenizer: " << count << " words, " << elapsed << " ms, " <<
+        numAllocations - before << " allocations" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+// Splits a string into words without copying them. Each word is a
+// std::string_view that points back into the original text, so the text must
+// outlive the words.
+//
+// The words are exactly the ones split() would produce:
+// * a run of delimiters counts as a single delimiter,
+// * leading delimiters produce one empty word at the start,
+// * trailing delimiters don't produce anything,
+// * an empty string produces a single empty word.
+class Tokenizer
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::string_view const*;
+        using reference = std::string_view const&;
+
+        Iterator() = default;
+
+        Iterator(std::string_view str, char delim) :
+            mStr{str},
+            mDelim{delim},
+            mWord{str.substr(0, str.find(delim))},
+            mAtEnd{false}
+        {  }
+
+        reference operator*() const
+        {
+            return mWord;
+        }
+
+        pointer operator->() const
+        {
+            return &mWord;
+        }
+
+        Iterator& operator++()
+        {
+            // Skip the delimiters that follow the current word.
+            auto pos = static_cast<std::size_t>(mWord.data() - mStr.data()) +
+                mWord.size();
+            while (pos < mStr.size() && mStr[pos] == mDelim)
+            {
+                ++pos;
+            }
+
+            if (pos == mStr.size())
+            {
+                // We've reached the end, turn into the end iterator.
+                *this = Iterator{};
+                return *this;
+            }
+
+            auto end = mStr.find(mDelim, pos);
+            mWord = mStr.substr(pos, end == std::string_view::npos ?
+                    std::string_view::npos : end - pos);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto copy = *this;
+            ++(*this);
+            return copy;
+        }
+
+        bool operator==(Iterator const& other) const
+        {
+            if (mAtEnd || other.mAtEnd)
+            {
+                return mAtEnd == other.mAtEnd;
+            }
+
+            return mWord.data() == other.mWord.data() &&
+                mWord.size() == other.mWord.size();
+        }
+
+        bool operator!=(Iterator const& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        std::string_view mStr{};
+        char mDelim{' '};
+        std::string_view mWord{};
+        bool mAtEnd{true};
+    };
+
+    Tokenizer(std::string_view str, char delim = ' ') :
+        mStr{str},
+        mDelim{delim}
+    {  }
+
+    Iterator begin() const
+    {
+        return Iterator{mStr, mDelim};
+    }
+
+    Iterator end() const
+    {
+        return Iterator{};
+    }
+
+private:
+    std::string_view mStr;
+    char mDelim;
+};
+
+// Same as Tokenizer, but stores the words in a vector supplied by the caller.
+// The vector is cleared first, so reusing it between lines means the only
+// allocations happen when a line has more words than any line before it.
+inline void split(std::string_view str, std::vector<std::string_view>& words,
+        char delim = ' ')
+{
+    words.clear();
+    for (auto word : Tokenizer{str, delim})
+    {
+        words.push_back(word);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <cstring>
+
+// A bump allocator for strings. Bytes are copied into large blocks one after
+// the other, and nothing is freed until the arena itself is destroyed. That
+// makes storing a string little more than a memcpy, and the string_views it
+// returns stay valid for as long as the arena lives (moving the arena doesn't
+// move the blocks).
+class Arena
+{
+public:
+    Arena(std::size_t blockSize = 1 << 16) :
+        mBlockSize{blockSize}
+    {  }
+
+    std::string_view store(std::string_view str)
+    {
+        if (str.empty())
+        {
+            return {};
+        }
+
+        if (str.size() > mRemaining)
+        {
+            // Strings bigger than a block get a block of their own.
+            auto size = std::max(mBlockSize, str.size());
+            mBlocks.emplace_back(new char[size]);
+            mNext = mBlocks.back().get();
+            mRemaining = size;
+            mReserved += size;
+        }
+
+        auto dest = mNext;
+        std::memcpy(dest, str.data(), str.size());
+        mNext += str.size();
+        mRemaining -= str.size();
+        return {dest, str.size()};
+    }
+
+    // The number of bytes the arena has allocated so far.
+    std::size_t reserved() const
+    {
+        return mReserved;
+    }
+
+private:
+    std::size_t mBlockSize;
+    std::vector<std::unique_ptr<char[]>> mBlocks;
+    char* mNext{nullptr};
+    std::size_t mRemaining{0};
+    std::size_t mReserved{0};
+};
@@ -0,0 +1,161 @@
+#include "../../week_5/code/Timer.hpp"
+#include "heavyhitters.hpp"
+#include "wordcounter.hpp"
+#include "wordstream.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <random>
+
+using atlas::core::Timer;
+
+// Same Zipf-distributed words as wordcount.cpp.
+std::vector<std::string_view> makeWords(std::vector<std::string>& vocabulary,
+        std::size_t count)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> length{2, 12};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    for (auto& word : vocabulary)
+    {
+        for (int i = length(gen); i > 0; --i)
+        {
+            word.push_back(static_cast<char>(letter(gen)));
+        }
+    }
+
+    std::vector<double> weights(vocabulary.size());
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+        weights[i] = 1.0 / (i + 1);
+    }
+    std::discrete_distribution<std::size_t> zipf{weights.begin(),
+        weights.end()};
+
+    std::vector<std::string_view> words(count);
+    for (auto& word : words)
+    {
+        word = vocabulary[zipf(gen)];
+    }
+    return words;
+}
+
+// Checks the reported counts against the exact ones: every true count must
+// lie within the reported bounds, and every word marked as guaranteed must
+// really be in the top k. Returns how many of the true top k were found.
+bool validate(HeavyHitters const& hitters, WordCounter const& exact,
+        std::size_t k, std::size_t& found)
+{
+    auto exactTop = exact.sortedByCount();
+    auto kthCount = (exactTop.size() >= k) ? exactTop[k - 1].occurrences : 0;
+
+    found = 0;
+    for (auto const& entry : hitters.top())
+    {
+        auto count = exact.count(entry.word);
+        if (count > entry.occurrences ||
+                count < entry.occurrences - entry.error ||
+                entry.error > hitters.maxError())
+        {
+            std::cout << entry.word << ": true count " << count <<
+                " outside the reported bounds" << std::endl;
+            return false;
+        }
+
+        if (entry.guaranteed && count < kthCount)
+        {
+            std::cout << entry.word << " wrongly guaranteed" << std::endl;
+            return false;
+        }
+
+        if (count >= kthCount)
+        {
+            ++found;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filename = (argc > 1) ? argv[1] : "text.txt";
+
+    // Few counters for a small text, so that some of them get taken over.
+    {
+        constexpr std::size_t k = 5;
+        HeavyHitters hitters{k, 0.05};
+        WordCounter exact;
+        if (!forEachWordInFile(filename, [&](std::string_view word)
+                    {
+                        hitters.add(word);
+                        exact.add(word);
+                    }))
+        {
+            std::cout << "Could not open " << filename << std::endl;
+            return 1;
+        }
+
+        std::size_t found{0};
+        if (!validate(hitters, exact, k, found))
+        {
+            return 1;
+        }
+        std::cout << filename << ": " << hitters.total() << " words, " <<
+            exact.size() << " unique, found " << found << " of the top " <<
+            k << ", max error " << hitters.maxError() << std::endl;
+    }
+
+    constexpr std::size_t numWords = 20000000;
+    std::vector<std::string> vocabulary(1000000);
+    auto words = makeWords(vocabulary, numWords);
+    Timer<std::chrono::milliseconds> timer;
+
+    WordCounter exact;
+    timer.start();
+    for (auto word : words)
+    {
+        exact.add(word);
+    }
+    auto exactTime = timer.elapsed().count();
+    std::cout << "Exact: " << exact.size() << " counters, " <<
+        numWords / (exactTime * 1000.0) << " million words/s" << std::endl;
+
+    std::cout << "k\tepsilon\tcounters\tmax error\tfound\tguaranteed\t"
+        "million words/s" << std::endl;
+    for (std::size_t k : {10, 100})
+    {
+        for (double epsilon : {1e-2, 1e-3, 1e-4})
+        {
+            HeavyHitters hitters{k, epsilon};
+            timer.start();
+            for (auto word : words)
+            {
+                hitters.add(word);
+            }
+            auto elapsed = timer.elapsed().count();
+
+            std::size_t found{0};
+            if (!validate(hitters, exact, k, found))
+            {
+                return 1;
+            }
+
+            std::size_t guaranteed{0};
+            for (auto const& entry : hitters.top())
+            {
+                guaranteed += entry.guaranteed;
+            }
+
+            std::cout << k << "\t" << epsilon << "\t" <<
+                std::max<std::size_t>(k + 1, 1 / epsilon) << "\t\t" <<
+                hitters.maxError() << "\t\t" << found << "\t" <<
+                guaranteed << "\t\t" <<
+                numWords / (elapsed * 1000.0) << std::endl;
+        }
+    }
+
+    return 0;
+}
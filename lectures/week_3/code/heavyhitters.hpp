@@ -0,0 +1,270 @@
+#pragma once
+
+#include "wordcounter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct HeavyHitter
+{
+    std::string_view word{};
+
+    // The true count is somewhere in [occurrences - error, occurrences].
+    std::size_t occurrences{0};
+    std::size_t error{0};
+
+    // True if the word is certain to be among the k most frequent words.
+    bool guaranteed{false};
+};
+
+// Finds the most frequent words of a stream in a fixed amount of memory using
+// the Space-Saving algorithm. We keep a fixed number of counters. A word that
+// already has a counter just increments it. A new word takes over the counter
+// with the smallest count and inherits that count as its (possible) error.
+//
+// With m counters, no count is ever off by more than n / m after n words, and
+// every word that appears more than n / m times is guaranteed to have a
+// counter. The counters sit in a min-heap so the smallest one is always at
+// hand, and a small hash index finds the counter for a word.
+class HeavyHitters
+{
+public:
+    // An epsilon of 0 would need endless counters. At this one they already
+    // take about 90 MB.
+    static constexpr double MinEpsilon{1.0e-6};
+
+    // Keeps enough counters to report the top k words with an error of at
+    // most epsilon times the number of words seen. A k of 0 counts as 1, and
+    // epsilon is kept within [MinEpsilon, 1].
+    HeavyHitters(std::size_t k, double epsilon) :
+        mK{std::max<std::size_t>(k, 1)}
+    {
+        // Written this way round so that NaN is raised too.
+        if (!(epsilon >= MinEpsilon))
+        {
+            epsilon = MinEpsilon;
+        }
+        epsilon = std::min(epsilon, 1.0);
+
+        auto numCounters = std::max(mK + 1,
+                static_cast<std::size_t>(std::ceil(1.0 / epsilon)));
+        mCounters.resize(numCounters);
+
+        std::size_t indexSize{16};
+        while (indexSize < 2 * numCounters)
+        {
+            indexSize *= 2;
+        }
+        mIndex.assign(indexSize, Empty);
+    }
+
+    void add(std::string_view word)
+    {
+        ++mTotal;
+        auto hash = hashWord(word);
+        auto pos = find(word, hash);
+        if (mIndex[pos] != Empty)
+        {
+            auto counter = mIndex[pos];
+            ++mCounters[counter].occurrences;
+            siftDown(mCounters[counter].heapPos);
+            return;
+        }
+
+        if (mHeap.size() < mCounters.size())
+        {
+            // There is still a free counter.
+            auto counter = mHeap.size();
+            auto& c = mCounters[counter];
+            c.word.assign(word);
+            c.hash = hash;
+            c.occurrences = 1;
+            c.error = 0;
+            c.heapPos = mHeap.size();
+            mHeap.push_back(counter);
+            mIndex[pos] = counter;
+            siftUp(c.heapPos);
+            return;
+        }
+
+        // Take over the smallest counter.
+        auto counter = mHeap.front();
+        auto& c = mCounters[counter];
+        erase(c.word, c.hash);
+        c.error = c.occurrences;
+        ++c.occurrences;
+        c.word.assign(word);
+        c.hash = hash;
+        mIndex[find(word, hash)] = counter;
+        siftDown(0);
+    }
+
+    // The number of words seen so far.
+    std::size_t total() const
+    {
+        return mTotal;
+    }
+
+    // The largest error any count can have.
+    std::size_t maxError() const
+    {
+        if (mHeap.size() < mCounters.size())
+        {
+            return 0;
+        }
+        return mCounters[mHeap.front()].occurrences;
+    }
+
+    // The k words with the highest counts, most frequent first.
+    std::vector<HeavyHitter> top() const
+    {
+        std::vector<HeavyHitter> result;
+        for (auto counter : mHeap)
+        {
+            auto const& c = mCounters[counter];
+            result.push_back({c.word, c.occurrences, c.error, false});
+        }
+
+        std::sort(result.begin(), result.end(),
+                [](HeavyHitter const& a, HeavyHitter const& b)
+                {
+                    if (a.occurrences != b.occurrences)
+                    {
+                        return a.occurrences > b.occurrences;
+                    }
+                    return a.word < b.word;
+                });
+
+        // Any word outside the first k counts at most as much as the (k+1)-th
+        // counter, and so does any word without a counter. A word whose lowest
+        // possible count beats that is certainly in the top k.
+        std::size_t threshold = (result.size() > mK) ?
+            result[mK].occurrences : 0;
+        if (result.size() > mK)
+        {
+            result.resize(mK);
+        }
+
+        for (auto& hitter : result)
+        {
+            hitter.guaranteed = hitter.occurrences - hitter.error >= threshold;
+        }
+
+        return result;
+    }
+
+private:
+    struct Counter
+    {
+        std::string word;
+        std::uint64_t hash{0};
+        std::size_t occurrences{0};
+        std::size_t error{0};
+        std::size_t heapPos{0};
+    };
+
+    static constexpr std::size_t Empty{~std::size_t{0}};
+
+    // Returns the index slot for the word: either the slot holding its counter
+    // or the empty slot where it would go.
+    std::size_t find(std::string_view word, std::uint64_t hash) const
+    {
+        auto mask = mIndex.size() - 1;
+        for (auto i = hash & mask; ; i = (i + 1) & mask)
+        {
+            auto counter = mIndex[i];
+            if (counter == Empty || (mCounters[counter].hash == hash &&
+                        mCounters[counter].word == word))
+            {
+                return i;
+            }
+        }
+    }
+
+    // Removes a word from the index. With linear probing we can't just empty
+    // the slot, since that would cut the probe sequence of the words after it,
+    // so those are shifted back to fill the hole.
+    void erase(std::string_view word, std::uint64_t hash)
+    {
+        auto mask = mIndex.size() - 1;
+        auto hole = find(word, hash);
+        mIndex[hole] = Empty;
+        for (auto i = (hole + 1) & mask; mIndex[i] != Empty; i = (i + 1) & mask)
+        {
+            auto home = mCounters[mIndex[i]].hash & mask;
+
+            // Move the entry into the hole unless its home lies in (hole, i].
+            bool between = (hole < i) ? (home > hole && home <= i) :
+                (home > hole || home <= i);
+            if (!between)
+            {
+                mIndex[hole] = mIndex[i];
+                mIndex[i] = Empty;
+                hole = i;
+            }
+        }
+    }
+
+    bool less(std::size_t a, std::size_t b) const
+    {
+        return mCounters[mHeap[a]].occurrences <
+            mCounters[mHeap[b]].occurrences;
+    }
+
+    void swapHeap(std::size_t a, std::size_t b)
+    {
+        std::swap(mHeap[a], mHeap[b]);
+        mCounters[mHeap[a]].heapPos = a;
+        mCounters[mHeap[b]].heapPos = b;
+    }
+
+    void siftUp(std::size_t pos)
+    {
+        while (pos > 0)
+        {
+            auto parent = (pos - 1) / 2;
+            if (!less(pos, parent))
+            {
+                break;
+            }
+            swapHeap(pos, parent);
+            pos = parent;
+        }
+    }
+
+    void siftDown(std::size_t pos)
+    {
+        while (true)
+        {
+            auto smallest = pos;
+            auto left = 2 * pos + 1;
+            auto right = left + 1;
+            if (left < mHeap.size() && less(left, smallest))
+            {
+                smallest = left;
+            }
+
+            if (right < mHeap.size() && less(right, smallest))
+            {
+                smallest = right;
+            }
+
+            if (smallest == pos)
+            {
+                break;
+            }
+            swapHeap(pos, smallest);
+            pos = smallest;
+        }
+    }
+
+    std::size_t mK;
+    std::size_t mTotal{0};
+    std::vector<Counter> mCounters;
+    std::vector<std::size_t> mHeap;
+    std::vector<std::size_t> mIndex;
+};
@@ -0,0 +1,119 @@
+#include "wordstream.hpp"
+#include "wordcounter.hpp"
+#include "mappedfile.hpp"
+#include "parallelcount.hpp"
+#include "heavyhitters.hpp"
+#include "wordstats.hpp"
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <cstdlib>
+
+void printStats(std::vector<WordCount> const& data)
+{
+    for (auto const& entry : data)
+    {
+        std::cout << entry.word << " : " << entry.occurrences << std::endl;
+    }
+}
+
+void printTop(HeavyHitters const& hitters)
+{
+    std::cout << "Counts are at most " << hitters.maxError() <<
+        " too high (* = certainly in the top)" << std::endl;
+    for (auto const& entry : hitters.top())
+    {
+        std::cout << entry.word << " : " << entry.occurrences;
+        if (entry.error > 0)
+        {
+            std::cout << " (>= " << entry.occurrences - entry.error << ")";
+        }
+        std::cout << (entry.guaranteed ? " *" : "") << std::endl;
+    }
+}
+
+// The word histogram from struct.cpp, counted with a hash table instead of a
+// linear search, with a few more ways to run it.
+int main(int argc, char* argv[])
+{
+    // Usage: histogram [--incremental] [filename] [count|alpha|topK]
+    //                  [threads]
+    // topK (e.g. top20) only keeps a fixed number of counters and reports the
+    // K most frequent words, so it works for inputs with any number of
+    // distinct words.
+    // --incremental saves the counts next to the file, and the next run only
+    // reads what was appended to the file since. It always uses one thread.
+    std::vector<std::string> args;
+    bool incremental{false};
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string{argv[i]} == "--incremental")
+        {
+            incremental = true;
+        }
+        else
+        {
+            args.emplace_back(argv[i]);
+        }
+    }
+
+    std::string filename = (args.size() > 0) ? args[0] : "text.txt";
+    std::string order = (args.size() > 1) ? args[1] : "count";
+    std::size_t threads = (args.size() > 2) ?
+        std::strtoull(args[2].c_str(), nullptr, 10) : 1;
+
+    if (order.compare(0, 3, "top") == 0)
+    {
+        std::size_t k = (order.size() > 3) ?
+            std::strtoull(order.c_str() + 3, nullptr, 10) : 10;
+        HeavyHitters hitters{k, 0.001};
+        if (forEachWordInFile(filename, [&hitters](std::string_view word)
+                    {
+                        hitters.add(word);
+                    }))
+        {
+            printTop(hitters);
+        }
+        return 0;
+    }
+
+    WordCounter stats;
+    bool opened{false};
+    if (incremental)
+    {
+        IncrementalWordStats incrementalStats{filename};
+        opened = incrementalStats.update();
+        stats = incrementalStats.counts();
+    }
+    else if (threads > 1)
+    {
+        // Map the whole file and let every thread count its own part of it.
+        MappedFile file{filename};
+        opened = file.is_open();
+        if (opened)
+        {
+            ThreadPool pool{threads};
+            stats = countWordsParallel(pool, file.view(), threads);
+        }
+    }
+    else
+    {
+        // The file is read in chunks and each word is counted as soon as it
+        // is found, so we never hold more than one chunk of the file in
+        // memory.
+        opened = forEachWordInFile(filename, [&stats](std::string_view word)
+                {
+                    stats.add(word);
+                });
+    }
+
+    if (opened)
+    {
+        printStats(order == "alpha" ? stats.sortedAlphabetically() :
+                stats.sortedByCount());
+    }
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "../../week_5/code/Timer.hpp"
+#include "interner.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <random>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+// mallinfo2 only exists in glibc 2.33 and later.
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define HAVE_MALLINFO2
+#include <malloc.h>
+#endif
+
+using atlas::core::Timer;
+
+#if defined(HAVE_MALLINFO2)
+// The number of bytes malloc has handed out and not yet had back, including
+// the padding it adds to every allocation, which is part of what small
+// allocations really cost. Big blocks are mapped separately and counted in
+// hblkhd.
+std::size_t liveBytes()
+{
+    auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+#else
+// Elsewhere we count the bytes passed to operator new ourselves, as
+// tokenizer.cpp does with the number of allocations. That leaves out
+// malloc's own padding, so small allocations look a bit cheaper than they
+// really are. Each block starts with its size, so that the unsized delete
+// knows how much to take back off.
+static std::size_t numLiveBytes{0};
+constexpr std::size_t Header{alignof(std::max_align_t)};
+
+void* operator new(std::size_t size)
+{
+    if (auto ptr = static_cast<char*>(std::malloc(size + Header)))
+    {
+        *reinterpret_cast<std::size_t*>(ptr) = size;
+        numLiveBytes += size;
+        return ptr + Header;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+    {
+        auto block = static_cast<char*>(ptr) - Header;
+        numLiveBytes -= *reinterpret_cast<std::size_t*>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+std::size_t liveBytes()
+{
+    return numLiveBytes;
+}
+#endif
+
+// Same Zipf-distributed words as wordcount.cpp.
+std::vector<std::string_view> makeWords(std::vector<std::string>& vocabulary,
+        std::size_t count)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> length{2, 12};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    for (auto& word : vocabulary)
+    {
+        for (int i = length(gen); i > 0; --i)
+        {
+            word.push_back(static_cast<char>(letter(gen)));
+        }
+    }
+
+    std::vector<double> weights(vocabulary.size());
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+        weights[i] = 1.0 / (i + 1);
+    }
+    std::discrete_distribution<std::size_t> zipf{weights.begin(),
+        weights.end()};
+
+    std::vector<std::string_view> words(count);
+    for (auto& word : words)
+    {
+        word = vocabulary[zipf(gen)];
+    }
+    return words;
+}
+
+// The usual way to give strings ids: a map from an owning string to its id,
+// plus a vector of strings to go back from the id.
+class MapInterner
+{
+public:
+    std::uint32_t intern(std::string_view str)
+    {
+        auto it = mIds.find(std::string{str});
+        if (it != mIds.end())
+        {
+            return it->second;
+        }
+
+        auto id = static_cast<std::uint32_t>(mStrings.size());
+        mStrings.emplace_back(str);
+        mIds.emplace(mStrings.back(), id);
+        return id;
+    }
+
+    std::size_t size() const
+    {
+        return mStrings.size();
+    }
+
+private:
+    std::unordered_map<std::string, std::uint32_t> mIds;
+    std::vector<std::string> mStrings;
+};
+
+int main()
+{
+    constexpr std::size_t numWords = 20000000;
+    std::vector<std::string> vocabulary(1000000);
+    auto words = makeWords(vocabulary, numWords);
+    Timer<std::chrono::milliseconds> timer;
+
+    auto report = [](std::string const& name, std::size_t unique,
+            std::size_t bytes, long long ms, std::uint64_t checksum)
+    {
+        std::cout << name << ": " << unique << " unique words, " <<
+            static_cast<double>(bytes) / unique << " bytes/word, " <<
+            numWords / (ms * 1000.0) << " million words/s (checksum " <<
+            checksum << ")" << std::endl;
+    };
+
+    {
+        auto before = liveBytes();
+        MapInterner interner;
+        std::uint64_t checksum{0};
+        timer.start();
+        for (auto word : words)
+        {
+            checksum += interner.intern(word);
+        }
+        auto elapsed = timer.elapsed().count();
+        report("std::unordered_map", interner.size(), liveBytes() - before,
+                elapsed, checksum);
+    }
+
+    {
+        auto before = liveBytes();
+        StringInterner interner;
+        std::uint64_t checksum{0};
+        timer.start();
+        for (auto word : words)
+        {
+            checksum += interner.intern(word);
+        }
+        auto elapsed = timer.elapsed().count();
+        report("StringInterner", interner.size(), liveBytes() - before,
+                elapsed, checksum);
+
+        // Every id must give back the string it was made from.
+        for (auto word : words)
+        {
+            if (interner.lookup(interner.find(word)) != word)
+            {
+                std::cout << "Lookup failed for " << word << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
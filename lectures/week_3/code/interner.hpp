@@ -0,0 +1,243 @@
+#pragma once
+
+#include "arena.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+// Hashes 8 bytes at a time instead of one, which matters since most of the
+// time spent counting words goes into hashing them. Every chunk goes through
+// fold first, so words that fold to the same bytes hash the same.
+template <typename ChunkFunction>
+std::uint64_t hashWord(std::string_view word, ChunkFunction fold)
+{
+    constexpr std::uint64_t k0{0x9e3779b97f4a7c15};
+    constexpr std::uint64_t k1{0xbf58476d1ce4e5b9};
+
+    auto mix = [](std::uint64_t h)
+    {
+        h ^= h >> 31;
+        h *= k1;
+        h ^= h >> 29;
+        return h;
+    };
+
+    std::uint64_t h{word.size() * k0};
+    auto data = word.data();
+    auto size = word.size();
+    while (size >= 8)
+    {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, data, 8);
+        h = mix(h ^ (fold(chunk) * k0));
+        data += 8;
+        size -= 8;
+    }
+
+    if (size > 0)
+    {
+        std::uint64_t chunk{0};
+        std::memcpy(&chunk, data, size);
+        h = mix(h ^ (fold(chunk) * k0));
+    }
+
+    return mix(h ^ k1);
+}
+
+inline std::uint64_t hashWord(std::string_view word)
+{
+    return hashWord(word, [](std::uint64_t chunk)
+            {
+                return chunk;
+            });
+}
+
+// Calls f(word, hashOf(word)) for every word in words, in order, until f
+// returns true. Returns whether it did.
+//
+// This is for tables bigger than the cache, where nearly every word costs a
+// miss on its slot, and looking the words up one at a time means waiting for
+// those misses one after the other. So the words are hashed Ahead words
+// before f gets them, and the slot at slotOf(hash) is prefetched right away,
+// which lets the misses overlap.
+//
+// The prefetch has to be issued here rather than by a function we are given:
+// the compiler sees that such a function has no effect and may drop the
+// call altogether.
+template <typename Words, typename HashFunction, typename SlotFunction,
+         typename BinaryFunction>
+bool forEachHashed(Words const& words, HashFunction hashOf,
+        SlotFunction slotOf, BinaryFunction f)
+{
+    constexpr std::size_t Ahead{16};
+    decltype(hashOf(*std::begin(words))) hashes[Ahead];
+    std::size_t hashed{0};
+    std::size_t done{0};
+    auto next = std::begin(words);
+    for (auto it = std::begin(words); it != std::end(words); ++it, ++done)
+    {
+        for (; hashed < done + Ahead && next != std::end(words);
+                ++next, ++hashed)
+        {
+            auto hash = hashOf(*next);
+            __builtin_prefetch(slotOf(hash));
+            hashes[hashed % Ahead] = hash;
+        }
+
+        if (f(*it, hashes[done % Ahead]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Gives every distinct string a small integer id. Ids are handed out in the
+// order strings are first seen, starting at 0, so they can index straight into
+// a vector. The bytes of each string are stored once in an arena, and the
+// string_view for an id never changes.
+//
+// The index is an open addressing table whose slots hold the id, 32 bits of
+// the hash and where the string lives, so a lookup never has to go through
+// the id table. Comparing the hash first means we only look at the string
+// itself when it is almost certainly a match.
+class StringInterner
+{
+public:
+    using Id = std::uint32_t;
+    static constexpr Id NotFound{~Id{0}};
+
+    StringInterner(std::size_t capacity = 1024)
+    {
+        std::size_t size{16};
+        while (size < 2 * capacity)
+        {
+            size *= 2;
+        }
+        mSlots.resize(size);
+        mStrings.reserve(capacity);
+    }
+
+    // Returns the id of the string, giving it a new one if we haven't seen it.
+    Id intern(std::string_view str)
+    {
+        auto hash = static_cast<std::uint32_t>(hashWord(str));
+        auto& slot = findSlot(str, hash);
+        if (slot.id != NotFound)
+        {
+            return slot.id;
+        }
+
+        auto id = static_cast<Id>(mStrings.size());
+        auto stored = mArena.store(str);
+        slot.data = stored.data();
+        slot.size = static_cast<std::uint32_t>(stored.size());
+        slot.id = id;
+        slot.hash = hash;
+        mStrings.push_back(stored);
+
+        // Keep the table at most half full so probe sequences stay short.
+        if (2 * mStrings.size() > mSlots.size())
+        {
+            grow();
+        }
+
+        return id;
+    }
+
+    // Returns the id of the string, or NotFound if it was never interned.
+    Id find(std::string_view str) const
+    {
+        auto hash = static_cast<std::uint32_t>(hashWord(str));
+        auto mask = mSlots.size() - 1;
+        for (auto i = hash & mask; ; i = (i + 1) & mask)
+        {
+            auto const& slot = mSlots[i];
+            if (slot.id == NotFound ||
+                    (slot.hash == hash && slot.view() == str))
+            {
+                return slot.id;
+            }
+        }
+    }
+
+    std::string_view lookup(Id id) const
+    {
+        return mStrings[id];
+    }
+
+    // The number of distinct strings, which is also the next id.
+    std::size_t size() const
+    {
+        return mStrings.size();
+    }
+
+    // The number of bytes used by the strings, the id table and the index.
+    std::size_t memory() const
+    {
+        return mArena.reserved() +
+            mStrings.capacity() * sizeof(std::string_view) +
+            mSlots.capacity() * sizeof(Slot);
+    }
+
+private:
+    struct Slot
+    {
+        char const* data{nullptr};
+        std::uint32_t size{0};
+        std::uint32_t hash{0};
+        Id id{NotFound};
+
+        std::string_view view() const
+        {
+            return {data, size};
+        }
+    };
+
+    // Returns the slot holding the string, or the empty slot where it belongs.
+    Slot& findSlot(std::string_view str, std::uint32_t hash)
+    {
+        auto mask = mSlots.size() - 1;
+        for (auto i = hash & mask; ; i = (i + 1) & mask)
+        {
+            auto& slot = mSlots[i];
+            if (slot.id == NotFound ||
+                    (slot.hash == hash && slot.view() == str))
+            {
+                return slot;
+            }
+        }
+    }
+
+    // Doubles the index. The hash kept in each slot is enough to place it
+    // again, so no string is hashed twice.
+    void grow()
+    {
+        std::vector<Slot> old(2 * mSlots.size());
+        std::swap(old, mSlots);
+
+        auto mask = mSlots.size() - 1;
+        for (auto const& slot : old)
+        {
+            if (slot.id == NotFound)
+            {
+                continue;
+            }
+
+            auto i = slot.hash & mask;
+            while (mSlots[i].id != NotFound)
+            {
+                i = (i + 1) & mask;
+            }
+            mSlots[i] = slot;
+        }
+    }
+
+    std::vector<Slot> mSlots;
+    std::vector<std::string_view> mStrings;
+    Arena mArena;
+};
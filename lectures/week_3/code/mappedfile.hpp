@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+// Gives read-only access to the contents of a file as one big string_view.
+// On POSIX systems the file is memory mapped, so nothing is read until it is
+// touched and the operating system takes care of paging it in. Elsewhere we
+// fall back to reading the whole file into memory.
+class MappedFile
+{
+public:
+    MappedFile(std::string const& filename)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        auto fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) == 0)
+        {
+            mSize = static_cast<std::size_t>(info.st_size);
+            mOpen = true;
+            if (mSize > 0)
+            {
+                auto data = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd,
+                        0);
+                if (data == MAP_FAILED)
+                {
+                    mOpen = false;
+                    mSize = 0;
+                }
+                else
+                {
+                    mData = static_cast<char const*>(data);
+                    ::madvise(data, mSize, MADV_SEQUENTIAL);
+                }
+            }
+        }
+
+        // The mapping stays valid after the file is closed.
+        ::close(fd);
+#else
+        std::ifstream file{filename, std::ios::binary};
+        if (file.is_open())
+        {
+            std::ostringstream contents;
+            contents << file.rdbuf();
+            mContents = contents.str();
+            mData = mContents.data();
+            mSize = mContents.size();
+            mOpen = true;
+        }
+#endif
+    }
+
+    ~MappedFile()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mData != nullptr)
+        {
+            ::munmap(const_cast<char*>(mData), mSize);
+        }
+#endif
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    void operator=(MappedFile const&) = delete;
+
+    bool is_open() const
+    {
+        return mOpen;
+    }
+
+    std::string_view view() const
+    {
+        return {mData, mSize};
+    }
+
+private:
+    char const* mData{nullptr};
+    std::size_t mSize{0};
+    bool mOpen{false};
+
+#if !defined(__unix__) && !defined(__APPLE__)
+    std::string mContents;
+#endif
+};
@@ -0,0 +1,104 @@
+#include "../../week_5/code/Timer.hpp"
+#include "parallelcount.hpp"
+
+#include <iostream>
+#include <string>
+#include <random>
+#include <thread>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+// Random words from a fixed vocabulary, separated by runs of spaces and
+// broken into lines of random length (some of them empty).
+std::string makeText(std::size_t size)
+{
+    std::mt19937 gen{116};
+    std::vector<std::string> vocabulary(100000);
+    std::uniform_int_distribution<int> length{1, 10};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    for (auto& word : vocabulary)
+    {
+        for (int i = length(gen); i > 0; --i)
+        {
+            word.push_back(static_cast<char>(letter(gen)));
+        }
+    }
+
+    std::uniform_int_distribution<std::size_t> pick{0, vocabulary.size() - 1};
+    std::uniform_int_distribution<int> spaces{1, 2};
+    std::uniform_int_distribution<int> newline{0, 15};
+
+    std::string text;
+    text.reserve(size + 64);
+    while (text.size() < size)
+    {
+        text += vocabulary[pick(gen)];
+        text.append(spaces(gen), ' ');
+        if (newline(gen) == 0)
+        {
+            text.push_back('\n');
+        }
+    }
+
+    return text;
+}
+
+bool sameCounts(WordCounter const& a, WordCounter const& b)
+{
+    auto left = a.sortedByCount();
+    auto right = b.sortedByCount();
+    if (left.size() != right.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < left.size(); ++i)
+    {
+        if (left[i].word != right[i].word ||
+                left[i].occurrences != right[i].occurrences)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    // The size of the text in MiB can be given on the command line.
+    std::size_t mib = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 512;
+    auto text = makeText(mib << 20);
+    Timer<std::chrono::milliseconds> timer;
+
+    WordCounter serial;
+    timer.start();
+    forEachWordInText(text, [&serial](std::string_view word)
+            {
+                serial.add(word);
+            });
+    auto serialTime = timer.elapsed().count();
+    std::cout << "Serial: " << serialTime << " ms" << std::endl;
+
+    std::size_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::cout << "threads\ttime (ms)\tspeedup" << std::endl;
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ThreadPool pool{threads};
+        timer.start();
+        auto counts = countWordsParallel(pool, text, threads);
+        auto elapsed = timer.elapsed().count();
+
+        if (!sameCounts(serial, counts))
+        {
+            std::cout << "Counts differ from the serial version!" << std::endl;
+            return 1;
+        }
+
+        std::cout << threads << "\t" << elapsed << "\t\t" <<
+            static_cast<double>(serialTime) / elapsed << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../../week_12/code/threadpool.hpp"
+#include "wordcounter.hpp"
+#include "wordstream.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+// Splits the text into roughly equal ranges. Every range except the first
+// starts right after a newline, so each range holds whole lines and splitting
+// it gives exactly the words the serial version would. A range may come out
+// empty if a single line spans several ranges.
+inline std::vector<std::string_view> splitIntoRanges(std::string_view text,
+        std::size_t numRanges)
+{
+    numRanges = std::max<std::size_t>(numRanges, 1);
+    std::vector<std::string_view> ranges;
+    std::size_t start{0};
+    for (std::size_t i = 1; i <= numRanges; ++i)
+    {
+        auto end = text.size() * i / numRanges;
+        if (i < numRanges)
+        {
+            end = std::max(end, start);
+            auto newline = text.find('\n', end);
+            end = (newline == std::string_view::npos) ? text.size() :
+                newline + 1;
+        }
+        else
+        {
+            end = text.size();
+        }
+
+        ranges.push_back(text.substr(start, end - start));
+        start = end;
+    }
+
+    return ranges;
+}
+
+// Counts the words in the text using every worker in the pool. Each range is
+// counted into its own table, so the threads never share anything while
+// counting, and the tables are then merged pairwise in a tree, which takes
+// log2(ranges) rounds of parallel merges.
+inline WordCounter countWordsParallel(ThreadPool& pool, std::string_view text,
+        std::size_t numRanges, char delim = ' ')
+{
+    auto ranges = splitIntoRanges(text, numRanges);
+    std::vector<WordCounter> counters(ranges.size());
+
+    parallelFor(pool, 0, ranges.size(), 1, [&](std::size_t i)
+            {
+                auto& counter = counters[i];
+                forEachWordInText(ranges[i], [&counter](std::string_view word)
+                        {
+                            counter.add(word);
+                        }, delim);
+            });
+
+    for (std::size_t step = 1; step < counters.size(); step *= 2)
+    {
+        auto numPairs = (counters.size() + 2 * step - 1) / (2 * step);
+        parallelFor(pool, 0, numPairs, 1, [&](std::size_t pair)
+                {
+                    auto left = 2 * step * pair;
+                    auto right = left + step;
+                    if (right < counters.size())
+                    {
+                        counters[left].merge(counters[right]);
+                    }
+                });
+    }
+
+    return std::move(counters.front());
+}
@@ -1,7 +1,9 @@
+#include "wordstream.hpp"
+
 #include <vector>
 #include <string>
+#include <string_view>
 #include <iostream>
-#include <fstream>
 
 struct WordData
 {
@@ -9,10 +11,11 @@ struct WordData
     int occurrences{0};
 };
 
-int find(std::vector<WordData> const& vec, std::string const& word)
+int find(std::vector<WordData> const& vec, std::string_view word)
 {
+    // Iterate by reference, otherwise every comparison copies the word.
     int idx = 0;
-    for (auto elem : vec)
+    for (auto const& elem : vec)
     {
         if (elem.word == word)
         {
@@ -24,90 +27,44 @@ int find(std::vector<WordData> const& vec, std::string const& word)
     return -1;
 }
 
-std::vector<std::string> split(std::string const& line, char delim = ' ')
+void printStats(std::vector<WordData> const& data)
 {
-    // Iterate over each character.
-    std::vector<std::string> words{};
-    std::string word{};
-    bool isSpace{false};
-    for (auto ch : line)
-    {
-        // If the current character is not the delimiter, add it to the string.
-        if (ch != delim)
-        {
-            isSpace = false;
-            word.push_back(ch);
-        }
-
-        // If it is the delimiter and it's the first time we have seen it, then
-        // the word is done. Save it on the vector and clear it for the
-        // next time.
-        if (ch == delim && !isSpace)
-        {
-            isSpace = true;
-            words.push_back(word);
-            word.clear();
-        }
-        
-        // If it is the delimiter and we have seen it before, then we don't
-        // care, continue.
-        if (ch == delim && isSpace)
-        {
-            continue;
-        }
-    }
-
-    // Check the final value of isSpace. If it ended in spaces, then
-    // we do nothing. If it didn't, then save the word.
-    if (!isSpace)
+    for (auto entry : data)
     {
-        words.push_back(word);
+        std::cout << entry.word << " : " << entry.occurrences << std::endl;
     }
-
-    return words;
 }
 
-void printStats(std::vector<WordData> const& data)
+void addWord(std::vector<WordData>& stats, std::string_view word)
 {
-    for (auto entry : data)
+    auto idx = find(stats, word);
+    if (idx != -1)
     {
-        std::cout << entry.word << " : " << entry.occurrences << std::endl;
+        stats.at(idx).occurrences++;
+        return;
     }
+
+    WordData data;
+    data.word = std::string{word};
+    data.occurrences = 1;
+    stats.push_back(data);
 }
 
 int main()
 {
     std::string filename{"text.txt"};
-    std::ifstream file;
-    file.open(filename);
     std::vector<WordData> stats;
 
-    if (file.is_open())
-    {
-        std::string line{};
-        while (std::getline(file, line))
-        {
-            // Split the line first.
-            auto words = split(line);
-
-            for (auto word : words)
+    // The file is read in chunks and each word is counted as soon as it is
+    // found, so we never hold more than one chunk of the file in memory.
+    auto opened = forEachWordInFile(filename, [&stats](std::string_view word)
             {
-                auto idx = find(stats, word);
-                if (idx != -1)
-                {
-                    stats.at(idx).occurrences++;
-                    continue;
-                }
-
-                WordData data;
-                data.word = word;
-                data.occurrences = 1;
-                stats.push_back(data);
-            }
-        }
+                addWord(stats, word);
+            });
 
+    if (opened)
+    {
         printStats(stats);
-        file.close();
     }
 
     return 0;
@@ -0,0 +1,129 @@
+#include "../../week_5/code/Timer.hpp"
+#include "wordcounter.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <random>
+#include <cmath>
+
+using atlas::core::Timer;
+
+// The counting from the original struct.cpp: a linear search over every word
+// seen so far.
+struct WordData
+{
+    std::string word{};
+    int occurrences{0};
+};
+
+void addLinear(std::vector<WordData>& stats, std::string_view word)
+{
+    for (auto& elem : stats)
+    {
+        if (elem.word == word)
+        {
+            elem.occurrences++;
+            return;
+        }
+    }
+
+    stats.push_back({std::string{word}, 1});
+}
+
+// Builds a text whose word frequencies follow Zipf's law, like real text
+// does: the k-th most common word shows up roughly 1/k as often as the first.
+std::vector<std::string_view> makeWords(std::vector<std::string>& vocabulary,
+        std::size_t count)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> length{2, 12};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    for (auto& word : vocabulary)
+    {
+        for (int i = length(gen); i > 0; --i)
+        {
+            word.push_back(static_cast<char>(letter(gen)));
+        }
+    }
+
+    std::vector<double> weights(vocabulary.size());
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+        weights[i] = 1.0 / (i + 1);
+    }
+    std::discrete_distribution<std::size_t> zipf{weights.begin(),
+        weights.end()};
+
+    std::vector<std::string_view> words(count);
+    for (auto& word : words)
+    {
+        word = vocabulary[zipf(gen)];
+    }
+    return words;
+}
+
+int main()
+{
+    constexpr std::size_t numWords = 20000000;
+    constexpr std::size_t numLinear = 200000;
+    std::vector<std::string> vocabulary(200000);
+    auto words = makeWords(vocabulary, numWords);
+    Timer<std::chrono::milliseconds> timer;
+
+    auto report = [](std::string const& name, std::size_t count, long long ms,
+            std::size_t unique)
+    {
+        std::cout << name << ": " << unique << " unique words, " <<
+            count / (ms * 1000.0) << " million words/s" << std::endl;
+    };
+
+    {
+        std::vector<WordData> stats;
+        timer.start();
+        for (std::size_t i = 0; i < numLinear; ++i)
+        {
+            addLinear(stats, words[i]);
+        }
+        report("Linear search (first " + std::to_string(numLinear) +
+                " words)", numLinear, timer.elapsed().count(), stats.size());
+    }
+
+    std::size_t expected;
+    {
+        std::unordered_map<std::string, std::size_t> stats;
+        timer.start();
+        for (auto word : words)
+        {
+            ++stats[std::string{word}];
+        }
+        expected = stats.size();
+        report("std::unordered_map", numWords, timer.elapsed().count(),
+                stats.size());
+    }
+
+    {
+        WordCounter stats;
+        timer.start();
+        for (auto word : words)
+        {
+            stats.add(word);
+        }
+        report("WordCounter", numWords, timer.elapsed().count(),
+                stats.size());
+
+        if (stats.size() != expected)
+        {
+            std::cout << "Unique counts differ!" << std::endl;
+            return 1;
+        }
+
+        auto top = stats.sortedByCount();
+        std::cout << "Most common: " << top[0].word << " : " <<
+            top[0].occurrences << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "interner.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+struct WordCount
+{
+    std::string_view word{};
+    std::size_t occurrences{0};
+};
+
+// Counts how many times each word appears. Every word is interned, so the
+// counts live in a plain vector indexed by word id and the words themselves
+// are stored once, in the interner's arena. Adding a word we have already
+// seen doesn't allocate anything.
+class WordCounter
+{
+public:
+    using Id = StringInterner::Id;
+
+    WordCounter(std::size_t capacity = 1024) :
+        mWords{capacity}
+    {
+        mCounts.reserve(capacity);
+    }
+
+    // Inserts the word if we haven't seen it, then adds count to it.
+    void add(std::string_view word, std::size_t count = 1)
+    {
+        auto id = mWords.intern(word);
+        if (id == mCounts.size())
+        {
+            mCounts.push_back(0);
+        }
+        mCounts[id] += count;
+    }
+
+    std::size_t count(std::string_view word) const
+    {
+        auto id = mWords.find(word);
+        return (id == StringInterner::NotFound) ? 0 : mCounts[id];
+    }
+
+    std::size_t count(Id id) const
+    {
+        return mCounts[id];
+    }
+
+    // The ids of the words, in the order they were first added.
+    StringInterner const& words() const
+    {
+        return mWords;
+    }
+
+    // The number of distinct words.
+    std::size_t size() const
+    {
+        return mCounts.size();
+    }
+
+    // Adds every count in other to ours.
+    void merge(WordCounter const& other)
+    {
+        other.forEach([this](std::string_view word, std::size_t count)
+                {
+                    add(word, count);
+                });
+    }
+
+    // Calls f(word, count) for every distinct word, in the order they were
+    // first added.
+    template <typename BinaryFunction>
+    void forEach(BinaryFunction f) const
+    {
+        for (Id id = 0; id < mCounts.size(); ++id)
+        {
+            f(mWords.lookup(id), mCounts[id]);
+        }
+    }
+
+    // Most frequent first. Words with the same count are sorted
+    // alphabetically.
+    std::vector<WordCount> sortedByCount() const
+    {
+        auto result = entries();
+        std::sort(result.begin(), result.end(),
+                [](WordCount const& a, WordCount const& b)
+                {
+                    if (a.occurrences != b.occurrences)
+                    {
+                        return a.occurrences > b.occurrences;
+                    }
+                    return a.word < b.word;
+                });
+        return result;
+    }
+
+    std::vector<WordCount> sortedAlphabetically() const
+    {
+        auto result = entries();
+        std::sort(result.begin(), result.end(),
+                [](WordCount const& a, WordCount const& b)
+                {
+                    return a.word < b.word;
+                });
+        return result;
+    }
+
+private:
+    std::vector<WordCount> entries() const
+    {
+        std::vector<WordCount> result;
+        result.reserve(size());
+        forEach([&result](std::string_view word, std::size_t count)
+                {
+                    result.push_back({word, count});
+                });
+        return result;
+    }
+
+    StringInterner mWords;
+    std::vector<std::size_t> mCounts;
+};
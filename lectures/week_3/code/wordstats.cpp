@@ -0,0 +1,181 @@
+#include "../../week_5/code/Timer.hpp"
+#include "wordstats.hpp"
+#include "wordcounter.hpp"
+#include "wordstream.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <random>
+#include <cstdio>
+
+using atlas::core::Timer;
+
+// Random words of 1 to 6 letters, mostly separated by spaces and now and then
+// by a newline.
+std::string makeText(std::mt19937& gen, std::size_t size)
+{
+    std::uniform_int_distribution<int> length{1, 6};
+    std::uniform_int_distribution<int> letter{'a', 'd'};
+    std::uniform_int_distribution<int> separator{0, 9};
+    std::string text;
+    while (text.size() < size)
+    {
+        for (int i = length(gen); i > 0; --i)
+        {
+            text.push_back(static_cast<char>(letter(gen)));
+        }
+        text.push_back(separator(gen) == 0 ? '\n' : ' ');
+    }
+    return text;
+}
+
+void writeFile(std::string const& filename, std::string const& text)
+{
+    std::ofstream out{filename, std::ios::binary | std::ios::trunc};
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+void appendFile(std::string const& filename, std::string const& text)
+{
+    std::ofstream out{filename, std::ios::binary | std::ios::app};
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+// Overwrites part of the file in place, keeping its length.
+void editFile(std::string const& filename, std::size_t offset,
+        std::string const& text)
+{
+    std::fstream out{filename, std::ios::binary | std::ios::in |
+        std::ios::out};
+    out.seekp(static_cast<std::streamoff>(offset));
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+WordCounter countAll(std::string const& filename)
+{
+    WordCounter counts;
+    forEachWordInFile(filename, [&counts](std::string_view word)
+            {
+                counts.add(word);
+            });
+    return counts;
+}
+
+bool sameCounts(WordCounter const& a, WordCounter const& b)
+{
+    auto x = a.sortedAlphabetically();
+    auto y = b.sortedAlphabetically();
+    if (x.size() != y.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        if (x[i].word != y[i].word || x[i].occurrences != y[i].occurrences)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Updates the stats of the file and compares them with a full recount.
+// expectedRead is how many bytes the update should have read.
+bool check(std::string const& what, std::string const& filename,
+        std::size_t expectedRead)
+{
+    IncrementalWordStats stats{filename};
+    if (!stats.update())
+    {
+        std::cout << what << ": could not open " << filename << std::endl;
+        return false;
+    }
+
+    if (!sameCounts(stats.counts(), countAll(filename)))
+    {
+        std::cout << what << ": counts differ from a full recount" <<
+            std::endl;
+        return false;
+    }
+
+    if (stats.bytesRead() != expectedRead)
+    {
+        std::cout << what << ": read " << stats.bytesRead() <<
+            " bytes, expected " << expectedRead << std::endl;
+        return false;
+    }
+
+    std::cout << what << ": ok" << std::endl;
+    return true;
+}
+
+int main()
+{
+    std::string filename{"wordstats.tmp.txt"};
+    std::string stateFilename{filename + ".wordstats"};
+    std::remove(stateFilename.c_str());
+
+    // A few blocks and then some, so that edits can land on either side of a
+    // block boundary.
+    std::mt19937 gen{41};
+    auto text = makeText(gen, 3 * IncrementalWordStats::ChecksumBlock + 12345);
+    writeFile(filename, text);
+    bool ok = check("first update", filename, text.size());
+
+    auto more = makeText(gen, 100000);
+    appendFile(filename, more);
+    text += more;
+    ok = ok && check("append", filename, more.size());
+    ok = ok && check("no change", filename, 0);
+
+    // Stop in the middle of a word, then finish it and start a new line.
+    appendFile(filename, "abcd");
+    text += "abcd";
+    ok = ok && check("append half a word", filename, 4);
+    appendFile(filename, "efgh\nnext line ");
+    text += "efgh\nnext line ";
+    ok = ok && check("finish the word", filename, 15);
+
+    // Same length edits in the first block, across a block boundary, and in
+    // the part past the last whole block. Each one must be noticed and the
+    // file counted again from the start.
+    for (auto offset : {std::size_t{1000},
+            IncrementalWordStats::ChecksumBlock - 3,
+            text.size() - 50})
+    {
+        editFile(filename, offset, "zzzzzz");
+        text.replace(offset, 6, "zzzzzz");
+        ok = ok && check("edit at " + std::to_string(offset), filename,
+                text.size());
+    }
+
+    // Cutting the file back also has to start over.
+    text.resize(text.size() / 2);
+    writeFile(filename, text);
+    ok = ok && check("truncate", filename, text.size());
+
+    // An update costs loading and saving the counts, a rehash of the old
+    // bytes and a count of the new ones, compared with a count of everything.
+    // With a large vocabulary the state file dominates.
+    more = makeText(gen, 1000);
+    appendFile(filename, more);
+    Timer<std::chrono::microseconds> timer;
+    timer.start();
+    IncrementalWordStats stats{filename};
+    stats.update();
+    auto incrementalTime = timer.elapsed().count();
+    timer.start();
+    auto counts = countAll(filename);
+    auto fullTime = timer.elapsed().count();
+    std::cout << "Appending " << more.size() << " bytes to " <<
+        text.size() << ": update " << incrementalTime << " us, recount " <<
+        fullTime << " us" << std::endl;
+
+    std::remove(filename.c_str());
+    std::remove(stateFilename.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "wordcounter.hpp"
+#include "wordstream.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Word counts for files that only ever grow, like logs. Instead of counting
+// the whole file every time, we save the counts along with how far into the
+// file we got, and the next time only the bytes added since then are read.
+//
+// The saved state holds everything needed to carry on exactly where we left
+// off: the scanner's state and the unfinished word at the old end of the file,
+// which may well continue in the new bytes.
+//
+// Before using the saved counts we make sure the part of the file we already
+// counted hasn't changed, edits in the middle included, by hashing all of it
+// again. Hashing is many times faster than counting words, so an update
+// still costs far less than a full recount, though it does read the whole
+// file. The hash is built from blocks of ChecksumBlock bytes, and the state
+// after the last complete block of the checked prefix is carried on over
+// the new bytes, so each old byte is read once per update.
+class IncrementalWordStats
+{
+public:
+    static constexpr std::size_t ChecksumBlock{1 << 20};
+
+    IncrementalWordStats(std::string filename, char delim = ' ') :
+        mFilename{std::move(filename)},
+        mStateFilename{mFilename + ".wordstats"},
+        mDelim{delim}
+    {  }
+
+    // Counts the words added to the file since the last update and saves the
+    // new state. Returns false if the file could not be opened.
+    bool update()
+    {
+        std::ifstream file{mFilename, std::ios::binary};
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        std::size_t hashed{0};
+        std::uint64_t blocks{0};
+        if (!load() || checksum(file, mOffset, hashed, blocks) != mChecksum)
+        {
+            // No usable state, so start from the beginning.
+            mCounts = WordCounter{};
+            mOffset = 0;
+            mCarried.clear();
+            mState = {};
+            hashed = 0;
+            blocks = 0;
+        }
+
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(mOffset));
+        WordScanner scanner{mDelim, mState};
+        auto add = [this](std::string_view word)
+        {
+            mCounts.add(word);
+        };
+        mBytesRead = scanStream(file, scanner, mCarried, add);
+        mOffset += mBytesRead;
+        mState = scanner.state();
+
+        mChecksum = checksum(file, mOffset, hashed, blocks);
+        save();
+        return true;
+    }
+
+    // The counts for the whole file, including the unfinished word at the
+    // end. That word isn't part of the saved counts, since more of it may be
+    // added later.
+    WordCounter counts() const
+    {
+        WordCounter result;
+        result.merge(mCounts);
+
+        WordScanner scanner{mDelim, mState};
+        auto add = [&result](std::string_view word)
+        {
+            result.add(word);
+        };
+        scanner.finish(mCarried, add);
+        return result;
+    }
+
+    // How many bytes the last update had to read.
+    std::size_t bytesRead() const
+    {
+        return mBytesRead;
+    }
+
+private:
+    // Returns the checksum of the first length bytes of the file, or 0 if
+    // the file is shorter than that. blocks holds the hash of the first
+    // hashed bytes, a whole number of blocks, and is carried on over every
+    // complete block of the prefix, so a later call can pick up from there.
+    static std::uint64_t checksum(std::ifstream& file, std::size_t length,
+            std::size_t& hashed, std::uint64_t& blocks)
+    {
+        std::string block(ChecksumBlock, '\0');
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(hashed));
+        while (hashed + ChecksumBlock <= length)
+        {
+            if (!file.read(block.data(), ChecksumBlock))
+            {
+                file.clear();
+                return 0;
+            }
+            blocks = (blocks ^ hashWord(block)) * 0x9e3779b97f4a7c15;
+            hashed += ChecksumBlock;
+        }
+
+        auto rest = length - hashed;
+        if (!file.read(block.data(), static_cast<std::streamsize>(rest)))
+        {
+            file.clear();
+            return 0;
+        }
+        file.clear();
+        return (blocks ^ hashWord(std::string_view{block.data(), rest})) +
+            length * 0x9e3779b97f4a7c15;
+    }
+
+    // The state file is text, one item per line. Words and the carried word
+    // are written as their length followed by their bytes, since they can
+    // hold any character but the delimiter and '\n'.
+    bool load()
+    {
+        std::ifstream in{mStateFilename, std::ios::binary};
+        std::string magic;
+        int delim{0};
+        std::size_t numWords{0};
+        if (!(in >> magic >> delim >> mOffset >> mChecksum >> mState.isDelim >>
+                    mState.inLine) || magic != "wordstats1" || delim != mDelim ||
+                !readWord(in, mCarried) || !(in >> numWords))
+        {
+            return false;
+        }
+
+        mCounts = WordCounter{numWords};
+        std::string word;
+        for (std::size_t i = 0; i < numWords; ++i)
+        {
+            std::size_t count{0};
+            if (!(in >> count) || !readWord(in, word))
+            {
+                return false;
+            }
+            mCounts.add(word, count);
+        }
+
+        return true;
+    }
+
+    // Writes to a temporary file first and renames it over the old one, so
+    // a crash in the middle never leaves a half-written state behind.
+    void save() const
+    {
+        auto tempFilename = mStateFilename + ".tmp";
+        {
+            std::ofstream out{tempFilename, std::ios::binary};
+            out << "wordstats1 " << static_cast<int>(mDelim) << " " << mOffset <<
+                " " << mChecksum << " " << mState.isDelim << " " <<
+                mState.inLine << "\n";
+            writeWord(out, mCarried);
+            out << mCounts.size() << "\n";
+            mCounts.forEach([&out](std::string_view word, std::size_t count)
+                    {
+                        out << count << " ";
+                        writeWord(out, word);
+                    });
+            if (!out)
+            {
+                return;
+            }
+        }
+
+        std::rename(tempFilename.c_str(), mStateFilename.c_str());
+    }
+
+    static void writeWord(std::ofstream& out, std::string_view word)
+    {
+        out << word.size() << " ";
+        out.write(word.data(), static_cast<std::streamsize>(word.size()));
+        out << "\n";
+    }
+
+    static bool readWord(std::ifstream& in, std::string& word)
+    {
+        std::size_t size{0};
+        if (!(in >> size) || in.get() != ' ')
+        {
+            return false;
+        }
+
+        word.resize(size);
+        in.read(word.data(), static_cast<std::streamsize>(size));
+        return static_cast<bool>(in);
+    }
+
+    std::string mFilename;
+    std::string mStateFilename;
+    char mDelim;
+
+    WordCounter mCounts;
+    std::size_t mOffset{0};
+    std::uint64_t mChecksum{0};
+    WordScanner::State mState;
+    std::string mCarried;
+    std::size_t mBytesRead{0};
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <fstream>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+// The words we want are the same ones we get from reading the text with
+// std::getline and calling split(line, delim) on every line, including the
+// empty word split gives for an empty line or a line that starts with a
+// delimiter. WordScanner produces those words without building the lines, and
+// can be fed the text one piece at a time.
+class WordScanner
+{
+public:
+    // Where the scanner is within the current line. Saving it along with the
+    // unfinished word lets a scan be picked up again later.
+    struct State
+    {
+        bool isDelim{false};
+        bool inLine{false};
+    };
+
+    WordScanner(char delim = ' ') :
+        mDelim{delim}
+    {  }
+
+    WordScanner(char delim, State state) :
+        mDelim{delim},
+        mIsDelim{state.isDelim},
+        mInLine{state.inLine}
+    {  }
+
+    State state() const
+    {
+        return {mIsDelim, mInLine};
+    }
+
+    // Calls f(word) for every word that ends in text[from, text.size()).
+    // Returns where the unfinished word at the end of the text starts, so the
+    // caller can carry it over to the next piece (if there is no unfinished
+    // word, the result is text.size()).
+    template <typename UnaryFunction>
+    std::size_t scan(std::string_view text, std::size_t from,
+            UnaryFunction& f)
+    {
+        std::size_t wordStart{0};
+        for (auto i = from; i < text.size(); ++i)
+        {
+            auto ch = text[i];
+            if (ch == '\n')
+            {
+                // The end of the line works like the end of split: the last
+                // word only counts if we weren't in a run of delimiters.
+                if (!mIsDelim)
+                {
+                    f(text.substr(wordStart, i - wordStart));
+                }
+
+                mIsDelim = false;
+                mInLine = false;
+                wordStart = i + 1;
+                continue;
+            }
+
+            mInLine = true;
+            if (ch == mDelim && !mIsDelim)
+            {
+                f(text.substr(wordStart, i - wordStart));
+                mIsDelim = true;
+            }
+            else if (ch != mDelim && mIsDelim)
+            {
+                wordStart = i;
+                mIsDelim = false;
+            }
+        }
+
+        return mIsDelim ? text.size() : wordStart;
+    }
+
+    // Call once there is no more text. The word is the unfinished word that
+    // scan left at the end, and it only counts if the last line had no
+    // newline.
+    template <typename UnaryFunction>
+    void finish(std::string_view word, UnaryFunction& f)
+    {
+        if (mInLine && !mIsDelim)
+        {
+            f(word);
+        }
+
+        mIsDelim = false;
+        mInLine = false;
+    }
+
+private:
+    char mDelim;
+    bool mIsDelim{false};
+    bool mInLine{false};
+};
+
+// Calls f(word) for every word in a block of text that is already in memory.
+template <typename UnaryFunction>
+void forEachWordInText(std::string_view text, UnaryFunction f,
+        char delim = ' ')
+{
+    WordScanner scanner{delim};
+    auto rest = scanner.scan(text, 0, f);
+    scanner.finish(text.substr(rest), f);
+}
+
+// Reads the rest of the stream in fixed-size chunks and passes it through the
+// scanner, without ever building the lines. A word that is cut off at the end
+// of a chunk is moved to the front of the buffer and finished with the next
+// chunk, so the memory used only depends on the chunk size (and on the
+// longest word), never on the size of the stream.
+//
+// carried is the unfinished word from before the stream starts (if any), and
+// holds the unfinished word at the end of the stream afterwards. Returns the
+// number of bytes read.
+template <typename UnaryFunction>
+std::size_t scanStream(std::istream& in, WordScanner& scanner,
+        std::string& carried, UnaryFunction& f,
+        std::size_t chunkSize = 1 << 20)
+{
+    std::vector<char> buffer(std::max(chunkSize, 2 * carried.size()));
+    std::memcpy(buffer.data(), carried.data(), carried.size());
+
+    // The first numCarried characters of the buffer are the unfinished word
+    // from the previous chunk.
+    std::size_t numCarried{carried.size()};
+    std::size_t bytesRead{0};
+    while (in)
+    {
+        // If the unfinished word fills the whole buffer, make room for it.
+        if (numCarried == buffer.size())
+        {
+            buffer.resize(2 * buffer.size());
+        }
+
+        in.read(buffer.data() + numCarried, buffer.size() - numCarried);
+        auto count = static_cast<std::size_t>(in.gcount());
+        if (count == 0)
+        {
+            break;
+        }
+        bytesRead += count;
+
+        std::string_view chunk{buffer.data(), numCarried + count};
+        auto wordStart = scanner.scan(chunk, numCarried, f);
+
+        // Keep the unfinished word (if any) for the next chunk.
+        numCarried = chunk.size() - wordStart;
+        std::memmove(buffer.data(), buffer.data() + wordStart, numCarried);
+    }
+
+    carried.assign(buffer.data(), numCarried);
+    return bytesRead;
+}
+
+// Calls f(word) for every word in a file, reading it in chunks with
+// scanStream.
+//
+// Returns false if the file could not be opened.
+template <typename UnaryFunction>
+bool forEachWordInFile(std::string const& filename, UnaryFunction f,
+        char delim = ' ', std::size_t chunkSize = 1 << 20)
+{
+    std::ifstream file{filename, std::ios::binary};
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    WordScanner scanner{delim};
+    std::string carried;
+    scanStream(file, scanner, carried, f, chunkSize);
+    scanner.finish(carried, f);
+    return true;
+}
@@ -0,0 +1,149 @@
+#include "../../week_5/code/Timer.hpp"
+#include "bloomfilter.hpp"
+#include "duplicates.hpp"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <random>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+// Distinct random words: numbers in base 26, written with letters and padded
+// with a random tail so they aren't all the same length.
+std::vector<std::string> makeWords(std::size_t count, std::size_t first)
+{
+    std::mt19937 gen{static_cast<unsigned>(first)};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::uniform_int_distribution<int> extra{0, 6};
+    std::vector<std::string> words(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto& word = words[i];
+        for (auto n = first + i; n > 0; n /= 26)
+        {
+            word.push_back(static_cast<char>('a' + n % 26));
+        }
+        word.push_back('_');
+        for (int n = extra(gen); n > 0; --n)
+        {
+            word.push_back(static_cast<char>(letter(gen)));
+        }
+    }
+    return words;
+}
+
+int main(int argc, char* argv[])
+{
+    // The number of distinct words in millions can be given on the command
+    // line. The filter is sized for them, then asked about as many others.
+    std::size_t millions = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) :
+        10;
+    auto count = millions * 1000000;
+    auto inserted = makeWords(count, 1);
+    auto others = makeWords(count, count + 1);
+
+    Timer<std::chrono::milliseconds> timer;
+    auto perSecond = [](std::size_t n, long long ms)
+    {
+        return static_cast<double>(n) * 1.0e-3 / static_cast<double>(ms);
+    };
+
+    for (double target : {0.01, 0.001, 0.0001})
+    {
+        BloomFilter filter{count, target};
+        std::cout << "Target " << target << ": " <<
+            static_cast<double>(filter.memory() * 8) /
+            static_cast<double>(count) << " bits per word" << std::endl;
+
+        timer.start();
+        for (auto const& word : inserted)
+        {
+            filter.insert(word);
+        }
+        std::cout << "  insert " << perSecond(count, timer.elapsed().count()) <<
+            " M/s";
+
+        timer.start();
+        std::size_t missed{0};
+        for (auto const& word : inserted)
+        {
+            missed += !filter.mayContain(word);
+        }
+        std::cout << ", lookup of inserted words " <<
+            perSecond(count, timer.elapsed().count()) << " M/s" <<
+            (missed == 0 ? "" : " FALSE NEGATIVES");
+
+        timer.start();
+        std::size_t falsePositives{0};
+        for (auto const& word : others)
+        {
+            falsePositives += filter.mayContain(word);
+        }
+        std::cout << ", of other words " <<
+            perSecond(count, timer.elapsed().count()) << " M/s" << std::endl;
+
+        timer.start();
+        std::size_t batchPositives{0};
+        filter.mayContainAll(others, [&batchPositives](auto const&, bool found)
+                {
+                    batchPositives += found;
+                });
+        std::cout << "  mayContainAll of other words " <<
+            perSecond(count, timer.elapsed().count()) << " M/s" <<
+            (batchPositives == falsePositives ? "" : " MISMATCH") << std::endl;
+
+        std::cout << "  false positive rate " <<
+            static_cast<double>(falsePositives) / static_cast<double>(count) <<
+            " (model " << filter.falsePositiveRate(count) << ")" << std::endl;
+    }
+
+    // The repeats question on a stream where every word shows up twice: the
+    // filter against an exact table, which has to keep every distinct word.
+    {
+        std::vector<std::string_view> stream;
+        stream.reserve(2 * count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            stream.push_back(inserted[i]);
+            stream.push_back(inserted[(i * 7919) % count]);
+        }
+
+        BloomFilter filter{count, 0.001};
+        timer.start();
+        std::size_t seen{0};
+        for (auto word : stream)
+        {
+            seen += filter.seenBefore(word);
+        }
+        std::cout << "Stream of " << stream.size() << " words, filter: " <<
+            perSecond(stream.size(), timer.elapsed().count()) << " M/s, " <<
+            filter.memory() / 1000000 << " MB, " << seen << " seen before";
+
+        filter.clear();
+        timer.start();
+        std::size_t batchSeen{0};
+        filter.seenBeforeAll(stream, [&batchSeen](std::string_view, bool found)
+                {
+                    batchSeen += found;
+                });
+        std::cout << "; seenBeforeAll: " <<
+            perSecond(stream.size(), timer.elapsed().count()) << " M/s" <<
+            (batchSeen == seen ? "" : " MISMATCH");
+
+        RepeatTable table;
+        timer.start();
+        std::size_t exact{0};
+        for (auto word : stream)
+        {
+            exact += table.add(word) > 1;
+        }
+        std::cout << "; RepeatTable: " <<
+            perSecond(stream.size(), timer.elapsed().count()) << " M/s, " <<
+            exact << " seen before" << std::endl;
+    }
+
+    return 0;
+}
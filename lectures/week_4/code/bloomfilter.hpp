@@ -0,0 +1,239 @@
+#pragma once
+
+#include "../../week_3/code/interner.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Answers "have we seen this word before?" in a fixed amount of memory, no
+// matter how many distinct words go by, at the price of sometimes saying yes
+// to a word we haven't seen. It never says no to one we have.
+//
+// This is a split block Bloom filter. The bits are cut into blocks of 256,
+// which is half a cache line, and every word sets or tests 8 bits within a
+// single block: one bit in each of its eight 32-bit lanes. So a lookup costs
+// one cache miss at most, and the eight bits come from eight multiplications
+// of the same hash by different odd constants, which the compiler turns into
+// a single vector multiply, shift and compare when it can use AVX2.
+//
+// The filter is sized from the number of words we expect and the false
+// positive rate we want. Going past the expected number still works, but the
+// rate goes up. Rates below MinFalsePositiveRate, including 0, are raised to
+// it: no number of blocks gets the rate to 0, and going lower would take
+// more than 100 bits per word, which is more than a hash table of the
+// words' 64-bit hashes needs.
+class BloomFilter
+{
+public:
+    static constexpr double MinFalsePositiveRate{1.0e-7};
+
+    BloomFilter(std::size_t expected, double falsePositiveRate)
+    {
+        // Written this way round so that NaN is raised too.
+        if (!(falsePositiveRate >= MinFalsePositiveRate))
+        {
+            falsePositiveRate = MinFalsePositiveRate;
+        }
+
+        // More blocks can only lower the rate, so we search for the fewest
+        // that are enough: double until we get there, then bisect.
+        std::size_t high{1};
+        while (falsePositives(expected, high) > falsePositiveRate)
+        {
+            high *= 2;
+        }
+
+        auto low = high / 2;
+        while (low + 1 < high)
+        {
+            auto mid = low + (high - low) / 2;
+            if (falsePositives(expected, mid) > falsePositiveRate)
+            {
+                low = mid;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        mBlocks.resize(high);
+    }
+
+    void insert(std::string_view word)
+    {
+        insert(hashWord(word));
+    }
+
+    void insert(std::uint64_t hash)
+    {
+        auto& block = mBlocks[blockIndex(hash)];
+        auto bits = mask(static_cast<std::uint32_t>(hash));
+        for (std::size_t i = 0; i < Lanes; ++i)
+        {
+            block.lanes[i] |= bits.lanes[i];
+        }
+    }
+
+    // False means the word was never inserted. True means it probably was.
+    bool mayContain(std::string_view word) const
+    {
+        return mayContain(hashWord(word));
+    }
+
+    bool mayContain(std::uint64_t hash) const
+    {
+        auto const& block = mBlocks[blockIndex(hash)];
+        auto bits = mask(static_cast<std::uint32_t>(hash));
+        std::uint32_t missing{0};
+        for (std::size_t i = 0; i < Lanes; ++i)
+        {
+            missing |= bits.lanes[i] & ~block.lanes[i];
+        }
+        return missing == 0;
+    }
+
+    // For streams: returns whether the word has probably been seen before,
+    // and remembers it either way.
+    bool seenBefore(std::string_view word)
+    {
+        return seenBefore(hashWord(word));
+    }
+
+    bool seenBefore(std::uint64_t hash)
+    {
+        auto& block = mBlocks[blockIndex(hash)];
+        auto bits = mask(static_cast<std::uint32_t>(hash));
+        std::uint32_t missing{0};
+        for (std::size_t i = 0; i < Lanes; ++i)
+        {
+            missing |= bits.lanes[i] & ~block.lanes[i];
+            block.lanes[i] |= bits.lanes[i];
+        }
+        return missing == 0;
+    }
+
+    // Call f(word, result) for every word in words, in order, with what
+    // mayContain or seenBefore would have returned for it. The blocks of the
+    // words coming up are prefetched, see forEachHashed in interner.hpp.
+    template <typename Words, typename BinaryFunction>
+    void mayContainAll(Words const& words, BinaryFunction f) const
+    {
+        forEachHashed(words, hasher(), blockOf(),
+                [this, &f](auto const& word, std::uint64_t hash)
+                {
+                    f(word, mayContain(hash));
+                    return false;
+                });
+    }
+
+    template <typename Words, typename BinaryFunction>
+    void seenBeforeAll(Words const& words, BinaryFunction f)
+    {
+        forEachHashed(words, hasher(), blockOf(),
+                [this, &f](auto const& word, std::uint64_t hash)
+                {
+                    f(word, seenBefore(hash));
+                    return false;
+                });
+    }
+
+    // The false positive rate we expect once count distinct words are in.
+    double falsePositiveRate(std::size_t count) const
+    {
+        return falsePositives(count, mBlocks.size());
+    }
+
+    // The number of bytes used by the bits.
+    std::size_t memory() const
+    {
+        return mBlocks.size() * sizeof(Block);
+    }
+
+    void clear()
+    {
+        std::fill(mBlocks.begin(), mBlocks.end(), Block{});
+    }
+
+private:
+    static constexpr std::size_t Lanes{8};
+
+    struct alignas(32) Block
+    {
+        std::uint32_t lanes[Lanes]{};
+    };
+
+    // The high half of the hash picks the block. Multiplying and keeping the
+    // top bits maps it onto any number of blocks without a division.
+    std::size_t blockIndex(std::uint64_t hash) const
+    {
+        return static_cast<std::size_t>(((hash >> 32) * mBlocks.size()) >> 32);
+    }
+
+    // The low half picks one bit in every lane: the top 5 bits of the hash
+    // times that lane's constant.
+    static Block mask(std::uint32_t hash)
+    {
+        constexpr std::uint32_t salts[Lanes]{0x47b6137b, 0x44974d91,
+            0x8824ad5b, 0xa2b7289d, 0x705495c7, 0x2df1424b, 0x9efc4947,
+            0x5c6bfb31};
+
+        Block bits;
+        for (std::size_t i = 0; i < Lanes; ++i)
+        {
+            bits.lanes[i] = std::uint32_t{1} << ((hash * salts[i]) >> 27);
+        }
+        return bits;
+    }
+
+    // For forEachHashed: the hash of a word (hashWord is overloaded, so it
+    // can't be passed as it is), and where the block of a hash is.
+    static auto hasher()
+    {
+        return [](std::string_view word)
+        {
+            return hashWord(word);
+        };
+    }
+
+    auto blockOf() const
+    {
+        return [this](std::uint64_t hash)
+        {
+            return &mBlocks[blockIndex(hash)];
+        };
+    }
+
+    // The chance that a word we never inserted finds all its bits set, once
+    // count words are spread over numBlocks blocks. The number of words in
+    // its block follows a Poisson distribution, and with i words there, each
+    // of its eight bits is set with probability 1 - (31/32)^i.
+    static double falsePositives(std::size_t count, std::size_t numBlocks)
+    {
+        auto perBlock = static_cast<double>(count) /
+            static_cast<double>(numBlocks);
+
+        // Blocks this full have every bit set, and exp would underflow.
+        if (perBlock > 500)
+        {
+            return 1;
+        }
+        auto limit = static_cast<std::size_t>(perBlock +
+                10 * std::sqrt(perBlock) + 10);
+
+        double rate{0};
+        auto poisson = std::exp(-perBlock);
+        for (std::size_t i = 0; i <= limit; ++i)
+        {
+            auto lane = 1 - std::pow(31.0 / 32.0, static_cast<double>(i));
+            rate += poisson * std::pow(lane, static_cast<double>(Lanes));
+            poisson *= perBlock / static_cast<double>(i + 1);
+        }
+        return rate;
+    }
+
+    std::vector<Block> mBlocks;
+};
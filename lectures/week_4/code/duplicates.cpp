@@ -0,0 +1,211 @@
+#include "../../week_5/code/Timer.hpp"
+#include "duplicates.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <random>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+// The repeats from q9.cpp, with its find, comparing every pair of words.
+bool find(std::vector<std::string> const& words, std::string const& word)
+{
+    for (auto w : words)
+    {
+        if (w == word)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<std::string> repeats(std::vector<std::string>const& words)
+{
+    std::vector<std::string> result;
+    for (std::size_t i{0}; i < words.size(); ++i)
+    {
+        for (std::size_t k{0}; k < words.size(); ++k)
+        {
+            if (i == k)
+            {
+                continue;
+            }
+
+            if (words.at(i) == words.at(k))
+            {
+                if (!find(result, words.at(i)))
+                {
+                    result.push_back(words.at(i));
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+// The usual way with the standard library: a map from a copy of every word
+// (lowercased if we ignore case) to where it sits in the result.
+std::vector<std::pair<std::string, std::size_t>> countRepeatsStd(
+        std::vector<std::string_view> const& words, CaseMode mode)
+{
+    std::unordered_map<std::string, std::size_t> index;
+    std::vector<std::pair<std::string, std::size_t>> all;
+    for (auto word : words)
+    {
+        std::string key{word};
+        if (mode == CaseMode::Insensitive)
+        {
+            for (auto& c : key)
+            {
+                c = static_cast<char>(std::tolower(
+                            static_cast<unsigned char>(c)));
+            }
+        }
+
+        auto [it, added] = index.emplace(key, all.size());
+        if (added)
+        {
+            all.push_back({std::string{word}, 0});
+        }
+        ++all[it->second].second;
+    }
+
+    std::vector<std::pair<std::string, std::size_t>> result;
+    for (auto& entry : all)
+    {
+        if (entry.second > 1)
+        {
+            result.push_back(std::move(entry));
+        }
+    }
+    return result;
+}
+
+bool sameResults(std::vector<WordCount> const& ours,
+        std::vector<std::pair<std::string, std::size_t>> const& theirs)
+{
+    return std::equal(ours.begin(), ours.end(), theirs.begin(), theirs.end(),
+            [](WordCount const& a, std::pair<std::string, std::size_t> const& b)
+            {
+                return a.word == b.first && a.occurrences == b.second;
+            });
+}
+
+// Random lowercase words picked uniformly from a vocabulary an eighth the
+// size of the text, so most words repeat and the table outgrows the cache.
+// A tenth of them are capitalized. The words point into the vocabulary,
+// which holds both spellings of every word.
+std::vector<std::string_view> makeWords(std::vector<std::string>& vocabulary,
+        std::size_t count)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> length{2, 12};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    auto distinct = std::max<std::size_t>(count / 8, 1);
+    vocabulary.resize(2 * distinct);
+    for (std::size_t i = 0; i < distinct; ++i)
+    {
+        auto& word = vocabulary[2 * i];
+        for (int n = length(gen); n > 0; --n)
+        {
+            word.push_back(static_cast<char>(letter(gen)));
+        }
+        vocabulary[2 * i + 1] = word;
+        vocabulary[2 * i + 1][0] = static_cast<char>(word[0] - 'a' + 'A');
+    }
+
+    std::uniform_int_distribution<std::size_t> pick{0, distinct - 1};
+    std::uniform_int_distribution<int> capital{0, 9};
+    std::vector<std::string_view> words(count);
+    for (auto& word : words)
+    {
+        word = vocabulary[2 * pick(gen) + (capital(gen) == 0)];
+    }
+    return words;
+}
+
+int main(int argc, char* argv[])
+{
+    // foldCase against tolower for every byte in every position.
+    for (int c = 0; c < 256; ++c)
+    {
+        for (int pos = 0; pos < 8; ++pos)
+        {
+            std::uint64_t chunk{0x4040404040404040};
+            chunk &= ~(std::uint64_t{0xff} << (8 * pos));
+            chunk |= static_cast<std::uint64_t>(c) << (8 * pos);
+            auto folded = static_cast<int>((foldCase(chunk) >> (8 * pos)) &
+                    0xff);
+            if (folded != ((c >= 'A' && c <= 'Z') ? c + 32 : c))
+            {
+                std::cout << "foldCase is wrong for " << c << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    Timer<std::chrono::milliseconds> timer;
+
+    // The pairwise version is quadratic, so it only gets a small text.
+    {
+        std::vector<std::string> vocabulary;
+        auto views = makeWords(vocabulary, 20000);
+        std::vector<std::string> words(views.begin(), views.end());
+        timer.start();
+        auto pairwise = repeats(words);
+        std::cout << words.size() << " words: pairwise " <<
+            timer.elapsed().count() << " ms";
+
+        timer.start();
+        auto hashed = findRepeats(words);
+        std::cout << ", findRepeats " << timer.elapsed().count() << " ms" <<
+            (std::equal(hashed.begin(), hashed.end(), pairwise.begin(),
+                        pairwise.end()) ? "" : " MISMATCH") << std::endl;
+    }
+
+    // The number of words in millions can be given on the command line. The
+    // copies the standard version makes don't fit in memory beyond a few tens
+    // of millions, so it only runs below that. 100 gives 1e8 words.
+    std::size_t millions = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) :
+        10;
+    constexpr std::size_t maxStdMillions{20};
+    std::vector<std::string> vocabulary;
+    auto words = makeWords(vocabulary, millions * 1000000);
+
+    for (auto mode : {CaseMode::Sensitive, CaseMode::Insensitive})
+    {
+        std::cout << words.size() << " words, case " <<
+            (mode == CaseMode::Sensitive ? "sensitive" : "insensitive") << ":";
+
+        // There is a repeat within the first few hundred words, so there is
+        // nothing to time for hasRepeats.
+        auto found = hasRepeats(words, mode);
+
+        timer.start();
+        auto counts = countRepeats(words, mode);
+        std::cout << " countRepeats " << timer.elapsed().count() << " ms (" <<
+            counts.size() << " repeated)";
+
+        if (millions <= maxStdMillions)
+        {
+            timer.start();
+            auto reference = countRepeatsStd(words, mode);
+            std::cout << ", unordered_map " << timer.elapsed().count() <<
+                " ms" << ((found && sameResults(counts, reference)) ? "" :
+                        " MISMATCH");
+        }
+
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
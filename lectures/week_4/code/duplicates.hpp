@@ -0,0 +1,262 @@
+#pragma once
+
+#include "../../week_3/code/interner.hpp"
+#include "../../week_3/code/wordcounter.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// Finding the words that appear more than once, in one pass instead of
+// comparing every pair.
+//
+// The words are never copied: the table remembers a string_view of the first
+// copy of each word it sees, so the words have to outlive it. Every distinct
+// word gets an id in the order it first appears, and its count lives in a
+// vector indexed by that id. Listing the repeats in order of first
+// appearance is then a walk over the ids, with no second pass over the words.
+//
+// Ids and counts are 32 bits, which is plenty for 1e8 words and keeps the
+// table small: a slot is just the id and 32 bits of the hash.
+
+enum class CaseMode
+{
+    Sensitive,
+    Insensitive
+};
+
+// Lowercases the ASCII letters among 8 bytes at once. Bytes that aren't ASCII
+// are left alone. Keeping each byte to 7 bits first means the additions below
+// can't carry into the next byte, and the top bit of each sum then tells us
+// whether the byte is at least 'A' and whether it is past 'Z'.
+inline std::uint64_t foldCase(std::uint64_t chunk)
+{
+    constexpr std::uint64_t ones{0x0101010101010101};
+    auto low = chunk & (0x7f * ones);
+    auto atLeastA = low + (0x80 - 'A') * ones;
+    auto pastZ = low + (0x80 - 'Z' - 1) * ones;
+    auto upper = atLeastA & ~pastZ & ~chunk & (0x80 * ones);
+    return chunk | (upper >> 2);
+}
+
+// Compares two words the way foldCase sees them, 8 bytes at a time.
+inline bool equalFolded(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+
+    std::size_t i{0};
+    for (; i + 8 <= a.size(); i += 8)
+    {
+        std::uint64_t x;
+        std::uint64_t y;
+        std::memcpy(&x, a.data() + i, 8);
+        std::memcpy(&y, b.data() + i, 8);
+        if (foldCase(x) != foldCase(y))
+        {
+            return false;
+        }
+    }
+
+    if (i < a.size())
+    {
+        std::uint64_t x{0};
+        std::uint64_t y{0};
+        std::memcpy(&x, a.data() + i, a.size() - i);
+        std::memcpy(&y, b.data() + i, a.size() - i);
+        return foldCase(x) == foldCase(y);
+    }
+
+    return true;
+}
+
+class RepeatTable
+{
+public:
+    using Id = std::uint32_t;
+    static constexpr Id NotFound{~Id{0}};
+
+    RepeatTable(CaseMode mode = CaseMode::Sensitive,
+            std::size_t capacity = 1024) :
+        mMode{mode}
+    {
+        std::size_t size{16};
+        while (size < 2 * capacity)
+        {
+            size *= 2;
+        }
+        mSlots.resize(size);
+        mWords.reserve(capacity);
+        mCounts.reserve(capacity);
+    }
+
+    // Counts the word and returns how many times we have seen it, this time
+    // included.
+    std::uint32_t add(std::string_view word)
+    {
+        return add(word, hash(word));
+    }
+
+    // Adds every word in words, and returns true as soon as one of them has
+    // been seen stopAt times. With stopAt at 0 that never happens. The slots
+    // of the words coming up are prefetched, see forEachHashed in
+    // interner.hpp.
+    template <typename Words>
+    bool addAll(Words const& words, std::uint32_t stopAt = 0)
+    {
+        return forEachHashed(words,
+                [this](std::string_view word)
+                {
+                    return hash(word);
+                },
+                [this](std::uint32_t h)
+                {
+                    return &mSlots[h & (mSlots.size() - 1)];
+                },
+                [this, stopAt](std::string_view word, std::uint32_t h)
+                {
+                    return add(word, h) == stopAt;
+                });
+    }
+
+    // Calls f(word, count) for every word seen more than once, in the order
+    // they first appeared. The word is the first copy we saw.
+    template <typename BinaryFunction>
+    void forEachRepeat(BinaryFunction f) const
+    {
+        for (std::size_t id = 0; id < mWords.size(); ++id)
+        {
+            if (mCounts[id] > 1)
+            {
+                f(mWords[id], mCounts[id]);
+            }
+        }
+    }
+
+    // The number of distinct words.
+    std::size_t size() const
+    {
+        return mWords.size();
+    }
+
+private:
+    struct Slot
+    {
+        std::uint32_t hash{0};
+        Id id{NotFound};
+    };
+
+    std::uint32_t hash(std::string_view word) const
+    {
+        return static_cast<std::uint32_t>(
+                (mMode == CaseMode::Sensitive) ? hashWord(word) :
+                hashWord(word, foldCase));
+    }
+
+    std::uint32_t add(std::string_view word, std::uint32_t hash)
+    {
+        auto mask = mSlots.size() - 1;
+        auto i = hash & mask;
+        for (; mSlots[i].id != NotFound; i = (i + 1) & mask)
+        {
+            auto const& slot = mSlots[i];
+            if (slot.hash == hash && equal(mWords[slot.id], word))
+            {
+                return ++mCounts[slot.id];
+            }
+        }
+
+        mSlots[i] = {hash, static_cast<Id>(mWords.size())};
+        mWords.push_back(word);
+        mCounts.push_back(1);
+
+        // Keep the table at most half full so probe sequences stay short.
+        if (2 * mWords.size() > mSlots.size())
+        {
+            grow();
+        }
+
+        return 1;
+    }
+
+    bool equal(std::string_view a, std::string_view b) const
+    {
+        return (mMode == CaseMode::Sensitive) ? a == b : equalFolded(a, b);
+    }
+
+    // Doubles the table. The hash kept in each slot is enough to place it
+    // again, so no word is hashed twice.
+    void grow()
+    {
+        std::vector<Slot> old(2 * mSlots.size());
+        std::swap(old, mSlots);
+
+        auto mask = mSlots.size() - 1;
+        for (auto const& slot : old)
+        {
+            if (slot.id == NotFound)
+            {
+                continue;
+            }
+
+            auto i = slot.hash & mask;
+            while (mSlots[i].id != NotFound)
+            {
+                i = (i + 1) & mask;
+            }
+            mSlots[i] = slot;
+        }
+    }
+
+    CaseMode mMode;
+    std::vector<Slot> mSlots;
+    std::vector<std::string_view> mWords;
+    std::vector<std::uint32_t> mCounts;
+};
+
+// Words can be any container of things that convert to std::string_view,
+// such as std::string.
+
+// Returns true as soon as we find a word we have already seen.
+template <typename Words>
+bool hasRepeats(Words const& words, CaseMode mode = CaseMode::Sensitive)
+{
+    RepeatTable table{mode};
+    return table.addAll(words, 2);
+}
+
+// The words that appear more than once, each listed once, in the order they
+// first appear.
+template <typename Words>
+std::vector<std::string_view> findRepeats(Words const& words,
+        CaseMode mode = CaseMode::Sensitive)
+{
+    RepeatTable table{mode};
+    table.addAll(words);
+
+    std::vector<std::string_view> result;
+    table.forEachRepeat([&result](std::string_view word, std::size_t)
+            {
+                result.push_back(word);
+            });
+    return result;
+}
+
+// Like findRepeats, along with how many times each word appears.
+template <typename Words>
+std::vector<WordCount> countRepeats(Words const& words,
+        CaseMode mode = CaseMode::Sensitive)
+{
+    RepeatTable table{mode};
+    table.addAll(words);
+
+    std::vector<WordCount> result;
+    table.forEachRepeat([&result](std::string_view word, std::size_t count)
+            {
+                result.push_back({word, count});
+            });
+    return result;
+}
@@ -1,27 +1,18 @@
+#include "../../week_2/code/asciicase.hpp"
+
 #include <vector>
 #include <string>
 #include <iostream>
-#include <cctype>
 
 void invertCaps(std::vector<std::string>& words)
 {
-    // Iterate by reference so the changes are reflected in the vector.
+    // Iterate by reference so the changes are reflected in the vector. Upper
+    // case letters become lower case and the other way around, and anything
+    // else is left alone. See asciicase.hpp for how this works on a whole
+    // word at once.
     for (auto& word : words)
     {
-        for (auto& ch : word)
-        {
-            // Check if it is uppercase. If it is, then turn to lower. If not
-            // then check if it is lowercase and convert to upper. If it is 
-            // neither, do nothing.
-            if (std::isupper(ch))
-            {
-                ch = std::tolower(ch);
-            }
-            else if (std::islower(ch))
-            {
-                ch = std::toupper(ch);
-            }
-        }
+        invertCase(word);
     }
 }
 
@@ -1,3 +1,6 @@
+#include "../../week_3/code/interner.hpp"
+#include "duplicates.hpp"
+
 #include <vector>
 #include <string>
 #include <iostream>
@@ -23,6 +26,24 @@ bool repeats(std::vector<std::string> const& words)
     return false;
 }
 
+// With the words interned, two words are equal exactly when their ids are, and
+// ids are small enough to index a table of the words we have seen, so a
+// single pass is enough.
+bool repeats(std::vector<StringInterner::Id> const& ids, std::size_t numIds)
+{
+    std::vector<bool> seen(numIds);
+    for (auto id : ids)
+    {
+        if (seen[id])
+        {
+            return true;
+        }
+        seen[id] = true;
+    }
+
+    return false;
+}
+
 int main()
 {
     std::vector<std::string> text1{"Some", "random", "text", "again"};
@@ -30,5 +51,20 @@ int main()
     std::cout << repeats(text1) << std::endl;
     std::cout << repeats(text2) << std::endl;
 
+    StringInterner interner;
+    std::vector<StringInterner::Id> ids;
+    for (auto const& word : text2)
+    {
+        ids.push_back(interner.intern(word));
+    }
+    std::cout << repeats(ids, interner.size()) << std::endl;
+
+    // Without interning first, a hash table of the words we have seen does
+    // the same in one pass. Ignoring case, "Some" and "some" are the same.
+    std::vector<std::string> text3{"Some", "random", "some", "text"};
+    std::cout << hasRepeats(text2) << std::endl;
+    std::cout << hasRepeats(text3) << " " <<
+        hasRepeats(text3, CaseMode::Insensitive) << std::endl;
+
     return 0;
 }
@@ -1,5 +1,9 @@
+#include "../../week_3/code/interner.hpp"
+#include "duplicates.hpp"
+
 #include <vector>
 #include <string>
+#include <string_view>
 #include <iostream>
 
 bool find(std::vector<std::string> const& words, std::string const& word)
@@ -41,6 +45,37 @@ std::vector<std::string> repeats(std::vector<std::string>const& words)
     return result;
 }
 
+// With the words interned we can count how many times each id shows up in a
+// table indexed by id. A second pass then picks out the words seen more than
+// once, in the order they first appear, just like the version above.
+std::vector<std::string_view> repeats(
+        std::vector<StringInterner::Id> const& ids,
+        StringInterner const& interner)
+{
+    std::vector<unsigned char> seen(interner.size());
+    for (auto id : ids)
+    {
+        if (seen[id] < 2)
+        {
+            ++seen[id];
+        }
+    }
+
+    std::vector<std::string_view> result;
+    for (auto id : ids)
+    {
+        if (seen[id] == 2)
+        {
+            result.push_back(interner.lookup(id));
+
+            // Make sure we only add it once.
+            seen[id] = 0;
+        }
+    }
+
+    return result;
+}
+
 void print(std::vector<std::string> const& vec)
 {
     if (vec.empty())
@@ -67,5 +102,33 @@ int main()
     print(rep1);
     print(rep2);
 
+    StringInterner interner;
+    std::vector<StringInterner::Id> ids;
+    for (auto const& word : text2)
+    {
+        ids.push_back(interner.intern(word));
+    }
+
+    for (auto word : repeats(ids, interner))
+    {
+        std::cout << word << " ";
+    }
+    std::cout << std::endl;
+
+    // The same without interning, from a hash table of the words, which can
+    // also count them and ignore case.
+    for (auto word : findRepeats(text2))
+    {
+        std::cout << word << " ";
+    }
+    std::cout << std::endl;
+
+    std::vector<std::string> text3{"Some", "random", "some", "text", "SOME"};
+    for (auto const& repeat : countRepeats(text3, CaseMode::Insensitive))
+    {
+        std::cout << repeat.word << " (" << repeat.occurrences << ") ";
+    }
+    std::cout << std::endl;
+
     return 0;
 }
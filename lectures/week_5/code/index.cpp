@@ -0,0 +1,137 @@
+#include "Timer.hpp"
+#include "staticindex.hpp"
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+
+using atlas::core::Timer;
+
+bool findVector(std::vector<int> const& vec, int elem)
+{
+    for (auto val : vec)
+    {
+        if (val == elem)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool findLowerBound(std::vector<int> const& vec, int elem)
+{
+    auto it = std::lower_bound(vec.begin(), vec.end(), elem);
+    return it != vec.end() && *it == elem;
+}
+
+// Runs every query through the search and returns the average time per
+// query in nanoseconds. The number of hits is kept so the compiler can't
+// throw the searches away.
+template <typename Search>
+double timeQueries(std::vector<int> const& queries, Search search,
+        std::size_t& hits)
+{
+    Timer<std::chrono::nanoseconds> timer;
+    hits = 0;
+    timer.start();
+    for (auto q : queries)
+    {
+        hits += search(q);
+    }
+    auto elapsed = timer.elapsed().count();
+    return static_cast<double>(elapsed) / queries.size();
+}
+
+int main(int argc, char* argv[])
+{
+    // The largest size can be given on the command line. The default is well
+    // past the size of most last-level caches.
+    std::size_t maxSize = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) :
+        (1 << 26);
+    constexpr std::size_t numQueries = 1000000;
+    constexpr std::size_t numLinear = 200;
+
+    std::mt19937 gen{116};
+
+    // A quick sanity check against the standard library first, on sizes
+    // that fill the last level of the tree to different depths, and on
+    // values before, between and past the elements.
+    for (std::size_t size = 0; size <= 40; ++size)
+    {
+        std::vector<int> vec(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            vec[i] = static_cast<int>(i + i / 3);
+        }
+        StaticIndex<int> index{vec};
+
+        for (int i = -1; i < static_cast<int>(2 * size) + 2; ++i)
+        {
+            auto it = std::lower_bound(vec.begin(), vec.end(), i);
+            auto bound = index.lower_bound(i);
+            bool boundMatches = (it == vec.end()) ? !bound.has_value() :
+                (bound.has_value() && *bound == *it);
+            if (index.rank(i) != static_cast<std::size_t>(it - vec.begin()) ||
+                    index.contains(i) != findVector(vec, i) || !boundMatches)
+            {
+                std::cout << "Mismatch at " << i << " in " << size <<
+                    " elements" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "size\tlinear\tlower_bound\tindex (ns/query)" << std::endl;
+    for (std::size_t size = 1 << 10; size <= maxSize; size *= 4)
+    {
+        // Use every other integer so that half the queries miss.
+        std::vector<int> vec(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            vec[i] = static_cast<int>(2 * i);
+        }
+
+        StaticIndex<int> index{vec};
+
+        std::uniform_int_distribution<int> dist{0, static_cast<int>(2 * size)};
+        std::vector<int> queries(numQueries);
+        for (auto& q : queries)
+        {
+            q = dist(gen);
+        }
+
+        std::vector<int> linearQueries{queries.begin(),
+            queries.begin() + numLinear};
+
+        std::size_t linearHits, stlHits, indexHits;
+        auto linear = timeQueries(linearQueries,
+                [&vec](int q) { return findVector(vec, q); }, linearHits);
+        auto stl = timeQueries(queries,
+                [&vec](int q) { return findLowerBound(vec, q); }, stlHits);
+        auto eytzinger = timeQueries(queries,
+                [&index](int q) { return index.contains(q); }, indexHits);
+
+        // Checking the hit counts also stops the compiler from discarding
+        // the searches as dead code.
+        std::size_t expected{0};
+        for (auto q : linearQueries)
+        {
+            expected += findLowerBound(vec, q);
+        }
+
+        if (stlHits != indexHits || linearHits != expected)
+        {
+            std::cout << "Hit counts differ!" << std::endl;
+            return 1;
+        }
+
+        std::cout << size << "\t" << linear << "\t" << stl << "\t\t" <<
+            eytzinger << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include "Timer.hpp"
+#include "parallelsort.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Compile with -DPARALLEL_STL -ltbb to compare against the parallel
+// std::sort, which libstdc++ runs on TBB.
+#if defined(PARALLEL_STL)
+#include <execution>
+#endif
+
+using atlas::core::Timer;
+
+std::vector<int> makeValues(std::size_t count, int maxValue)
+{
+    std::mt19937 gen{116};
+    std::uniform_int_distribution<int> value{0, maxValue};
+    std::vector<int> values(count);
+    for (auto& v : values)
+    {
+        v = value(gen);
+    }
+    return values;
+}
+
+// Sizes around the cutoff, few distinct values, already sorted input and a
+// custom comparator, on pools too big for the machine.
+bool check()
+{
+    for (std::size_t threads : {2, 3, 8})
+    {
+        ThreadPool pool{threads};
+        for (std::size_t size : {0, 1, 1000, 65535, 65536, 300000})
+        {
+            for (int maxValue : {0, 3, 1000000000})
+            {
+                auto values = makeValues(size, maxValue);
+                auto expected = values;
+                std::sort(expected.begin(), expected.end());
+                parallelSort(pool, values);
+                if (values != expected)
+                {
+                    return false;
+                }
+
+                parallelSort(pool, values, std::greater<int>{});
+                std::reverse(expected.begin(), expected.end());
+                if (values != expected)
+                {
+                    return false;
+                }
+            }
+        }
+
+        std::vector<std::string> words(100000);
+        for (std::size_t i = 0; i < words.size(); ++i)
+        {
+            words[i] = std::to_string(i * 7919 % 100003);
+        }
+        auto expected = words;
+        std::sort(expected.begin(), expected.end());
+        parallelSort(pool, words);
+        if (words != expected)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (!check())
+    {
+        std::cout << "parallelSort differs from std::sort!" << std::endl;
+        return 1;
+    }
+
+    // The number of values in millions can be given on the command line, and
+    // after it the most threads to try, which defaults to one per core.
+    std::size_t millions = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) :
+        100;
+    std::size_t maxThreads = (argc > 2) ?
+        std::strtoull(argv[2], nullptr, 10) :
+        std::max(std::thread::hardware_concurrency(), 1u);
+    auto values = makeValues(millions * 1000000, 1000000000);
+    Timer<std::chrono::milliseconds> timer;
+
+    auto expected = values;
+    timer.start();
+    std::sort(expected.begin(), expected.end());
+    auto serialTime = timer.elapsed().count();
+    std::cout << "std::sort: " << serialTime << " ms" << std::endl;
+
+    std::cout << "threads\ttime (ms)\tspeedup" << std::endl;
+    for (std::size_t threads = 1; ; threads = std::min(2 * threads,
+                maxThreads))
+    {
+        ThreadPool pool{threads};
+        auto copy = values;
+        timer.start();
+        parallelSort(pool, copy);
+        auto elapsed = timer.elapsed().count();
+
+        if (copy != expected)
+        {
+            std::cout << "parallelSort differs from std::sort!" << std::endl;
+            return 1;
+        }
+
+        std::cout << threads << "\t" << elapsed << "\t\t" <<
+            static_cast<double>(serialTime) / elapsed << std::endl;
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+
+#if defined(PARALLEL_STL)
+    {
+        auto copy = values;
+        timer.start();
+        std::sort(std::execution::par, copy.begin(), copy.end());
+        auto elapsed = timer.elapsed().count();
+        std::cout << "std::sort(std::execution::par): " << elapsed << " ms, " <<
+            static_cast<double>(serialTime) / elapsed << "x" <<
+            (copy == expected ? "" : " MISMATCH") << std::endl;
+    }
+#endif
+
+    return 0;
+}
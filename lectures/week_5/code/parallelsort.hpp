@@ -0,0 +1,169 @@
+#pragma once
+
+#include "../../week_12/code/threadpool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+// Sorts a vector with every worker of a pool, using sample sort:
+//
+// 1. Sort a random sample of the values and pick evenly spaced splitters
+//    from it. The splitters cut the values into buckets of about the same
+//    size.
+// 2. Cut the vector into blocks, and have one task per block find the
+//    bucket of each of its values and count how many go to each bucket.
+// 3. From the counts, every block knows where its share of each bucket
+//    starts, so the blocks move their values into a buffer side by side
+//    without ever writing to the same place.
+// 4. Sort every bucket on its own with std::sort, and move it back.
+//
+// Each value is compared against the splitters once and moved twice, and
+// the rest is the usual serial sort on pieces that fit better in the cache.
+// A value equal to a splitter goes to a bucket of its own, which is already
+// sorted, so many equal keys don't end up in one huge bucket.
+//
+// All the blocks share one buffer instead of each thread having its own:
+// the counts already give every block a disjoint range to write, and a
+// bucket then sits in one piece in the buffer, ready to be sorted. Nothing
+// in the buffer is initialized up front, which would be a serial pass over
+// all of it; each value is moved into place by the task that scatters it.
+//
+// Small vectors, and pools with a single worker, just use std::sort. Like
+// std::sort, the order of equal elements isn't kept.
+
+// Below this many elements the work isn't worth splitting.
+constexpr std::size_t ParallelSortCutoff{1 << 16};
+
+template <typename T, typename Compare = std::less<T>>
+void parallelSort(ThreadPool& pool, std::vector<T>& values,
+        Compare less = Compare{})
+{
+    auto size = values.size();
+    auto threads = pool.size();
+    if (size < ParallelSortCutoff || threads < 2)
+    {
+        std::sort(values.begin(), values.end(), less);
+        return;
+    }
+
+    // Several buckets and blocks per thread, so that one that runs long
+    // doesn't hold everyone up.
+    constexpr std::size_t Oversampling{16};
+    auto numSplitters = std::min<std::size_t>(8 * threads, 255);
+    auto numBlocks = 4 * threads;
+
+    std::mt19937_64 gen{116};
+    std::uniform_int_distribution<std::size_t> position{0, size - 1};
+    std::vector<T> splitters;
+    splitters.reserve((numSplitters + 1) * Oversampling);
+    for (std::size_t i = 0; i < (numSplitters + 1) * Oversampling; ++i)
+    {
+        splitters.push_back(values[position(gen)]);
+    }
+    std::sort(splitters.begin(), splitters.end(), less);
+    for (std::size_t i = 0; i < numSplitters; ++i)
+    {
+        splitters[i] = splitters[(i + 1) * Oversampling];
+    }
+    splitters.erase(splitters.begin() + numSplitters, splitters.end());
+    splitters.erase(std::unique(splitters.begin(), splitters.end(),
+                [&less](T const& a, T const& b)
+                {
+                    return !less(a, b);
+                }), splitters.end());
+    numSplitters = splitters.size();
+
+    // Bucket 2i holds the values between splitters i - 1 and i, and bucket
+    // 2i + 1 those equal to splitter i. The search is branchless, like
+    // forEachRank in batchsearch.hpp, and counts the splitters not greater
+    // than the value.
+    auto numBuckets = 2 * numSplitters + 1;
+    auto bucketOf = [&splitters, &less](T const& value)
+    {
+        auto base = splitters.data();
+        for (auto length = splitters.size(); length > 1; length -= length / 2)
+        {
+            auto half = length / 2;
+            base = less(value, base[half]) ? base : base + half;
+        }
+        auto rank = static_cast<std::size_t>(base - splitters.data()) +
+            !less(value, *base);
+
+        if (rank == 0 || less(splitters[rank - 1], value))
+        {
+            return 2 * rank;
+        }
+        return 2 * rank - 1;
+    };
+
+    // Each block keeps its own counts, and then its own write positions.
+    auto blockBegin = [size, numBlocks](std::size_t block)
+    {
+        return size * block / numBlocks;
+    };
+    std::unique_ptr<std::uint16_t[]> buckets{new std::uint16_t[size]};
+    std::vector<std::vector<std::size_t>> counts(numBlocks,
+            std::vector<std::size_t>(numBuckets));
+    parallelFor(pool, 0, numBlocks, 1, [&](std::size_t block)
+            {
+                auto& count = counts[block];
+                for (auto i = blockBegin(block); i < blockBegin(block + 1);
+                        ++i)
+                {
+                    auto b = bucketOf(values[i]);
+                    buckets[i] = static_cast<std::uint16_t>(b);
+                    ++count[b];
+                }
+            });
+
+    // Bucket by bucket, and within each bucket block by block.
+    std::vector<std::size_t> bucketBegin(numBuckets + 1);
+    std::size_t offset{0};
+    for (std::size_t b = 0; b < numBuckets; ++b)
+    {
+        bucketBegin[b] = offset;
+        for (auto& count : counts)
+        {
+            auto next = offset + count[b];
+            count[b] = offset;
+            offset = next;
+        }
+    }
+    bucketBegin[numBuckets] = size;
+
+    std::allocator<T> alloc;
+    auto release = [&alloc, size](T* p)
+    {
+        alloc.deallocate(p, size);
+    };
+    std::unique_ptr<T, decltype(release)> storage{alloc.allocate(size),
+        release};
+    auto buffer = storage.get();
+    parallelFor(pool, 0, numBlocks, 1, [&](std::size_t block)
+            {
+                auto& next = counts[block];
+                for (auto i = blockBegin(block); i < blockBegin(block + 1);
+                        ++i)
+                {
+                    new (buffer + next[buckets[i]]++) T(std::move(values[i]));
+                }
+            });
+
+    parallelFor(pool, 0, numBuckets, 1, [&](std::size_t b)
+            {
+                auto first = buffer + bucketBegin[b];
+                auto last = buffer + bucketBegin[b + 1];
+                if (b % 2 == 0)
+                {
+                    std::sort(first, last, less);
+                }
+                std::move(first, last, values.begin() + bucketBegin[b]);
+                std::destroy(first, last);
+            });
+}
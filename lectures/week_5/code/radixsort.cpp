@@ -0,0 +1,216 @@
+#include "Timer.hpp"
+#include "radixsort.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using atlas::core::Timer;
+
+template <typename T>
+std::vector<T> makeValues(std::size_t count, std::mt19937_64& gen)
+{
+    std::vector<T> values(count);
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        std::uniform_real_distribution<T> value{-1.0e6, 1.0e6};
+        for (auto& v : values)
+        {
+            v = value(gen);
+        }
+    }
+    else
+    {
+        std::uniform_int_distribution<T> value{
+            std::numeric_limits<T>::min(), std::numeric_limits<T>::max()};
+        for (auto& v : values)
+        {
+            v = value(gen);
+        }
+    }
+    return values;
+}
+
+// Short random words of lowercase letters, as in the word counting code.
+template <>
+std::vector<std::string> makeValues(std::size_t count, std::mt19937_64& gen)
+{
+    std::uniform_int_distribution<int> length{2, 12};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::vector<std::string> values(count);
+    for (auto& v : values)
+    {
+        for (int i = length(gen); i > 0; --i)
+        {
+            v.push_back(static_cast<char>(letter(gen)));
+        }
+    }
+    return values;
+}
+
+// Sorting (key, position) pairs by key with few distinct keys shows whether
+// equal keys stay in order.
+template <typename Key>
+bool checkStable(std::vector<Key> const& keys)
+{
+    std::vector<std::pair<Key, std::size_t>> records(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        records[i] = {keys[i], i};
+    }
+
+    auto expected = records;
+    std::stable_sort(expected.begin(), expected.end(),
+            [](auto const& a, auto const& b)
+            {
+                return a.first < b.first;
+            });
+    stableRadixSort(records, [](auto const& record) -> Key const&
+            {
+                return record.first;
+            });
+    return records == expected;
+}
+
+template <typename T>
+bool checkSorts(std::vector<T> const& values)
+{
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    auto unstable = values;
+    radixSort(unstable);
+    auto stable = values;
+    stableRadixSort(stable);
+    return unstable == expected && stable == expected;
+}
+
+// Edge cases of every kind, at sizes on both sides of the cutoffs.
+bool check()
+{
+    std::mt19937_64 gen{116};
+    for (std::size_t size : {0, 1, 2, 100, 255, 256, 1000, 100000})
+    {
+        auto ints = makeValues<int>(size, gen);
+        auto small = ints;
+        for (auto& v : small)
+        {
+            v %= 5;
+        }
+        auto words = makeValues<std::string>(size, gen);
+        auto prefixes = words;
+        for (std::size_t i = 0; i < prefixes.size(); ++i)
+        {
+            prefixes[i] = std::string(i % 40, 'a') + prefixes[i].substr(0, 1);
+        }
+
+        auto floats = makeValues<float>(size, gen);
+        for (std::size_t i = 0; i < floats.size(); i += 7)
+        {
+            floats[i] = (i % 2 == 0) ? std::numeric_limits<float>::infinity() :
+                -std::numeric_limits<float>::max();
+        }
+
+        if (!checkSorts(ints) || !checkSorts(small) ||
+                !checkSorts(makeValues<std::int64_t>(size, gen)) ||
+                !checkSorts(makeValues<std::uint32_t>(size, gen)) ||
+                !checkSorts(makeValues<std::uint64_t>(size, gen)) ||
+                !checkSorts(floats) ||
+                !checkSorts(makeValues<double>(size, gen)) ||
+                !checkSorts(words) || !checkSorts(prefixes) ||
+                !checkStable(small) || !checkStable(prefixes))
+        {
+            std::cout << "Mismatch for " << size << " values" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every sort gets a fresh copy of the same values. Small sizes are repeated
+// so the times are long enough to measure, and the times are per sort.
+template <typename T>
+void benchmark(std::string const& name, std::size_t maxSize)
+{
+    std::mt19937_64 gen{116};
+    Timer<std::chrono::microseconds> timer;
+    std::cout << name << " (ms per sort, speedup over std::sort)" << std::endl;
+    for (std::size_t size = 10000; size <= maxSize; size *= 10)
+    {
+        auto values = makeValues<T>(size, gen);
+        auto repeats = std::max<std::size_t>(1, 10000000 / size);
+        std::vector<T> copy;
+        auto time = [&](auto sort)
+        {
+            long long us{0};
+            for (std::size_t r = 0; r < repeats; ++r)
+            {
+                copy = values;
+                timer.start();
+                sort(copy);
+                us += timer.elapsed().count();
+            }
+            return static_cast<double>(us) * 1.0e-3 /
+                static_cast<double>(repeats);
+        };
+
+        auto sortTime = time([](std::vector<T>& v)
+                {
+                    std::sort(v.begin(), v.end());
+                });
+        auto expected = copy;
+        auto radixTime = time([](std::vector<T>& v)
+                {
+                    radixSort(v);
+                });
+        auto same = copy == expected;
+        auto stableTime = time([](std::vector<T>& v)
+                {
+                    std::stable_sort(v.begin(), v.end());
+                });
+        auto stableRadixTime = time([](std::vector<T>& v)
+                {
+                    stableRadixSort(v);
+                });
+        same = same && copy == expected;
+
+        std::cout << size << ": std::sort " << sortTime << ", radixSort " <<
+            radixTime << " (" << sortTime / radixTime << "x), " <<
+            "std::stable_sort " << stableTime << ", stableRadixSort " <<
+            stableRadixTime << " (" << stableTime / stableRadixTime << "x)" <<
+            (same ? "" : " MISMATCH") << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (!check())
+    {
+        return 1;
+    }
+
+    // The largest size, as a power of ten, can be given on the command line.
+    // Each run holds three copies of the values, plus the buffer of the
+    // stable sorts, so 1e9 ints need 16 GB. Strings take 32 bytes each
+    // before their characters, so they stop at 1e7.
+    int maxPower = (argc > 1) ? std::atoi(argv[1]) : 7;
+    std::size_t maxSize{1};
+    for (int i = 0; i < maxPower; ++i)
+    {
+        maxSize *= 10;
+    }
+
+    benchmark<int>("int", maxSize);
+    benchmark<std::int64_t>("int64_t", maxSize);
+    benchmark<float>("float", maxSize);
+    benchmark<double>("double", maxSize);
+    benchmark<std::string>("string",
+            std::min<std::size_t>(maxSize, 10000000));
+
+    return 0;
+}
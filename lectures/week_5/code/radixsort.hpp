@@ -0,0 +1,597 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Sorts that look at the bytes of the keys instead of comparing them. For
+// ints, floats and short words that is a fixed amount of work per element
+// per byte, where std::sort needs about log2(n) comparisons per element, each
+// of them a branch it can't predict.
+//
+// - Numbers (any integer or floating point type) are sorted by their bytes
+//   from the least significant up. stableRadixSort does that with a scratch
+//   buffer, one pass per byte. radixSort goes from the most significant byte
+//   down and swaps elements into place, so it needs no buffer but isn't
+//   stable.
+// - Strings (anything that converts to std::string_view) are sorted from the
+//   first character on, splitting into one bucket per character and then
+//   sorting each bucket by the next character. Small buckets are handed to a
+//   multikey quicksort, or to std::stable_sort in the stable version.
+//
+// Both take an optional key function, so records can be sorted by one field.
+// The key must return a number or something that converts to a string_view.
+
+// Sizes below which the comparison sorts are faster than another round of
+// counting.
+constexpr std::size_t RadixSmallNumbers{64};
+constexpr std::size_t RadixSmallStrings{64};
+
+// Maps a number to an unsigned integer with the same order, so its bytes can
+// be sorted as they are. Signed integers get their sign bit flipped. Positive
+// floats get their sign bit set, and negative ones have every bit flipped so
+// that larger magnitudes come first. -0.0 ends up just below 0.0, and NaNs
+// at either end depending on their sign.
+template <typename T>
+auto radixKey(T value)
+{
+    static_assert(std::is_arithmetic_v<T>, "radixKey needs a number");
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8,
+                "radixKey needs a float or a double");
+        using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t,
+              std::uint64_t>;
+        constexpr Bits sign{Bits{1} << (8 * sizeof(Bits) - 1)};
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return static_cast<Bits>((bits & sign) ? ~bits : bits | sign);
+    }
+    else if constexpr (std::is_signed_v<T>)
+    {
+        using Bits = std::make_unsigned_t<T>;
+        constexpr Bits sign{static_cast<Bits>(Bits{1} <<
+                (8 * sizeof(Bits) - 1))};
+        return static_cast<Bits>(static_cast<Bits>(value) ^ sign);
+    }
+    else
+    {
+        return value;
+    }
+}
+
+// The character at depth plus one, or 0 past the end, so that a string sorts
+// before every longer string that starts with it.
+inline std::size_t radixChar(std::string_view str, std::size_t depth)
+{
+    return (depth < str.size()) ?
+        static_cast<unsigned char>(str[depth]) + std::size_t{1} : 0;
+}
+
+// The scratch buffer of the stable sorts. It starts out as raw memory, so
+// making one costs no pass over it and T needs no default constructor. Values
+// are move-constructed into it by scatter, and once live is set they are
+// destroyed along with it.
+template <typename T>
+struct RadixBuffer
+{
+    explicit RadixBuffer(std::size_t count) :
+        size{count},
+        data{alloc.allocate(count)}
+    {  }
+
+    RadixBuffer(RadixBuffer const&) = delete;
+    RadixBuffer& operator=(RadixBuffer const&) = delete;
+
+    ~RadixBuffer()
+    {
+        if (live)
+        {
+            std::destroy_n(data, size);
+        }
+        alloc.deallocate(data, size);
+    }
+
+    std::allocator<T> alloc;
+    std::size_t size;
+    T* data;
+    bool live{false};
+};
+
+// Moves every value in [first, last) to to + offsets[bucket(value)]++, where
+// to is raw memory. The values of bucket b end up in [start of b,
+// offsets[b]), so if a move throws, those are the ones destroyed again.
+template <typename T, std::size_t N, typename BucketFunction>
+void scatter(T* first, T* last, T* to, std::array<std::size_t, N>& offsets,
+        BucketFunction const& bucket)
+{
+    auto starts = offsets;
+    try
+    {
+        for (auto it = first; it != last; ++it)
+        {
+            // Only count the value as moved once the move is done.
+            auto& offset = offsets[bucket(*it)];
+            new (to + offset) T(std::move(*it));
+            ++offset;
+        }
+    }
+    catch (...)
+    {
+        for (std::size_t b = 0; b < N; ++b)
+        {
+            std::destroy(to + starts[b], to + offsets[b]);
+        }
+        throw;
+    }
+}
+
+// Numbers.
+
+// Sorts values on every byte of the key, from the least significant, moving
+// them between values and a buffer. Each pass is stable, so when it is done
+// values are sorted on all of them.
+template <typename T, typename KeyFunction>
+void stableRadixSortBytes(std::vector<T>& values, KeyFunction const& key)
+{
+    using Key = decltype(radixKey(key(std::declval<T const&>())));
+    constexpr std::size_t Bytes{sizeof(Key)};
+
+    auto size = values.size();
+    auto digit = [&key](T const& value, std::size_t byte)
+    {
+        return static_cast<std::size_t>(
+                (radixKey(key(value)) >> (8 * byte)) & 0xff);
+    };
+
+    if (size < RadixSmallNumbers)
+    {
+        std::stable_sort(values.begin(), values.end(),
+                [&key](T const& a, T const& b)
+                {
+                    return radixKey(key(a)) < radixKey(key(b));
+                });
+        return;
+    }
+
+    // One pass counts every byte at once.
+    std::array<std::array<std::size_t, 256>, Bytes> counts{};
+    for (auto const& value : values)
+    {
+        auto k = radixKey(key(value));
+        for (std::size_t byte = 0; byte < Bytes; ++byte)
+        {
+            ++counts[byte][(k >> (8 * byte)) & 0xff];
+        }
+    }
+
+    RadixBuffer<T> buffer{size};
+    auto from = values.data();
+    auto to = buffer.data;
+    for (std::size_t byte = 0; byte < Bytes; ++byte)
+    {
+        // A byte that is the same everywhere wouldn't move anything.
+        auto& count = counts[byte];
+        if (count[digit(from[0], byte)] == size)
+        {
+            continue;
+        }
+
+        std::size_t offset{0};
+        for (auto& c : count)
+        {
+            auto next = offset + c;
+            c = offset;
+            offset = next;
+        }
+
+        if (to == buffer.data && !buffer.live)
+        {
+            // The first pass that moves anything fills the buffer.
+            scatter(from, from + size, to, count,
+                    [&digit, byte](T const& value)
+                    {
+                        return digit(value, byte);
+                    });
+            buffer.live = true;
+        }
+        else
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                to[count[digit(from[i], byte)]++] = std::move(from[i]);
+            }
+        }
+        std::swap(from, to);
+    }
+
+    if (from != values.data())
+    {
+        std::move(from, from + size, values.data());
+    }
+}
+
+// Sorts [first, last) on the bytes of the key from byte down. The elements
+// in each bucket are swapped straight to where they belong (this is the
+// American flag sort), then each bucket is sorted on the next byte.
+template <typename T, typename KeyFunction>
+void radixSortBytes(T* first, T* last, KeyFunction const& key,
+        std::size_t byte)
+{
+    auto digit = [&key, &byte](T const& value)
+    {
+        return static_cast<std::size_t>(
+                (radixKey(key(value)) >> (8 * byte)) & 0xff);
+    };
+
+    while (true)
+    {
+        auto size = static_cast<std::size_t>(last - first);
+        if (size < RadixSmallNumbers)
+        {
+            std::sort(first, last, [&key](T const& a, T const& b)
+                    {
+                        return radixKey(key(a)) < radixKey(key(b));
+                    });
+            return;
+        }
+
+        std::array<std::size_t, 256> counts{};
+        for (auto it = first; it != last; ++it)
+        {
+            ++counts[digit(*it)];
+        }
+
+        // With only one bucket there is nothing to move, so go straight to
+        // the next byte.
+        if (counts[digit(*first)] == size)
+        {
+            if (byte == 0)
+            {
+                return;
+            }
+            --byte;
+            continue;
+        }
+
+        std::array<std::size_t, 256> heads;
+        std::array<std::size_t, 256> tails;
+        std::size_t offset{0};
+        for (std::size_t b = 0; b < 256; ++b)
+        {
+            heads[b] = offset;
+            offset += counts[b];
+            tails[b] = offset;
+        }
+
+        for (std::size_t b = 0; b < 256; ++b)
+        {
+            while (heads[b] < tails[b])
+            {
+                auto value = std::move(first[heads[b]]);
+                auto d = digit(value);
+                while (d != b)
+                {
+                    std::swap(value, first[heads[d]++]);
+                    d = digit(value);
+                }
+                first[heads[b]++] = std::move(value);
+            }
+        }
+
+        if (byte == 0)
+        {
+            return;
+        }
+
+        std::size_t begin{0};
+        for (auto count : counts)
+        {
+            if (count > 1)
+            {
+                radixSortBytes(first + begin, first + begin + count, key,
+                        byte - 1);
+            }
+            begin += count;
+        }
+        return;
+    }
+}
+
+// Strings.
+
+// Sorts [first, last), whose keys agree on their first depth characters, by
+// splitting it three ways on the character at depth: less than a pivot,
+// equal to it and greater. Only the middle part moves on to the next
+// character. This is Bentley and Sedgewick's multikey quicksort.
+template <typename T, typename KeyFunction>
+void multikeyQuicksort(T* first, T* last, KeyFunction const& key,
+        std::size_t depth)
+{
+    auto at = [&key, &depth](T const& value)
+    {
+        return radixChar(key(value), depth);
+    };
+
+    while (last - first > 1)
+    {
+        auto size = last - first;
+        if (size < 16)
+        {
+            std::sort(first, last, [&key, depth](T const& a, T const& b)
+                    {
+                        return std::string_view{key(a)}.substr(depth) <
+                            std::string_view{key(b)}.substr(depth);
+                    });
+            return;
+        }
+
+        // The median of the first, middle and last characters.
+        auto a = at(first[0]);
+        auto b = at(first[size / 2]);
+        auto c = at(last[-1]);
+        auto pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        auto less = first;
+        auto greater = last;
+        for (auto it = first; it < greater; )
+        {
+            auto ch = at(*it);
+            if (ch < pivot)
+            {
+                std::swap(*less++, *it++);
+            }
+            else if (ch > pivot)
+            {
+                std::swap(*it, *--greater);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        multikeyQuicksort(first, less, key, depth);
+        multikeyQuicksort(greater, last, key, depth);
+
+        // Keys that ended at depth are all equal.
+        if (pivot == 0)
+        {
+            return;
+        }
+        first = less;
+        last = greater;
+        ++depth;
+    }
+}
+
+// Sorts [first, last), whose keys agree on their first depth characters, by
+// swapping every element into the bucket of its character at depth, then
+// sorting each bucket from the next character on. Bucket 0 holds the keys
+// that end at depth, which are all equal.
+template <typename T, typename KeyFunction>
+void radixSortChars(T* first, T* last, KeyFunction const& key,
+        std::size_t depth)
+{
+    constexpr std::size_t Buckets{257};
+    auto at = [&key, &depth](T const& value)
+    {
+        return radixChar(key(value), depth);
+    };
+
+    while (true)
+    {
+        auto size = static_cast<std::size_t>(last - first);
+        if (size < RadixSmallStrings)
+        {
+            multikeyQuicksort(first, last, key, depth);
+            return;
+        }
+
+        std::array<std::size_t, Buckets> counts{};
+        for (auto it = first; it != last; ++it)
+        {
+            ++counts[at(*it)];
+        }
+
+        auto only = at(*first);
+        if (counts[only] == size)
+        {
+            if (only == 0)
+            {
+                return;
+            }
+            ++depth;
+            continue;
+        }
+
+        std::array<std::size_t, Buckets> heads;
+        std::array<std::size_t, Buckets> tails;
+        std::size_t offset{0};
+        for (std::size_t b = 0; b < Buckets; ++b)
+        {
+            heads[b] = offset;
+            offset += counts[b];
+            tails[b] = offset;
+        }
+
+        for (std::size_t b = 0; b < Buckets; ++b)
+        {
+            while (heads[b] < tails[b])
+            {
+                auto value = std::move(first[heads[b]]);
+                auto ch = at(value);
+                while (ch != b)
+                {
+                    std::swap(value, first[heads[ch]++]);
+                    ch = at(value);
+                }
+                first[heads[b]++] = std::move(value);
+            }
+        }
+
+        std::size_t begin{counts[0]};
+        for (std::size_t b = 1; b < Buckets; ++b)
+        {
+            if (counts[b] > 1)
+            {
+                radixSortChars(first + begin, first + begin + counts[b], key,
+                        depth + 1);
+            }
+            begin += counts[b];
+        }
+        return;
+    }
+}
+
+// Like radixSortChars, but each element is moved out to buffer (raw memory,
+// see RadixBuffer) in order and back, which keeps equal keys in the order
+// they came in. Multikey quicksort
+// isn't stable, so small buckets go to std::stable_sort instead.
+template <typename T, typename KeyFunction>
+void stableRadixSortChars(T* first, T* last, T* buffer,
+        KeyFunction const& key, std::size_t depth)
+{
+    constexpr std::size_t Buckets{257};
+    auto at = [&key, &depth](T const& value)
+    {
+        return radixChar(key(value), depth);
+    };
+
+    while (true)
+    {
+        auto size = static_cast<std::size_t>(last - first);
+        if (size < RadixSmallStrings)
+        {
+            std::stable_sort(first, last,
+                    [&key, depth](T const& a, T const& b)
+                    {
+                        return std::string_view{key(a)}.substr(depth) <
+                            std::string_view{key(b)}.substr(depth);
+                    });
+            return;
+        }
+
+        std::array<std::size_t, Buckets> counts{};
+        for (auto it = first; it != last; ++it)
+        {
+            ++counts[at(*it)];
+        }
+
+        auto only = at(*first);
+        if (counts[only] == size)
+        {
+            if (only == 0)
+            {
+                return;
+            }
+            ++depth;
+            continue;
+        }
+
+        std::array<std::size_t, Buckets> offsets;
+        std::size_t offset{0};
+        for (std::size_t b = 0; b < Buckets; ++b)
+        {
+            offsets[b] = offset;
+            offset += counts[b];
+        }
+
+        // The buffer is raw memory again once the values are back.
+        scatter(first, last, buffer, offsets, at);
+        try
+        {
+            std::move(buffer, buffer + size, first);
+        }
+        catch (...)
+        {
+            std::destroy_n(buffer, size);
+            throw;
+        }
+        std::destroy_n(buffer, size);
+
+        std::size_t begin{counts[0]};
+        for (std::size_t b = 1; b < Buckets; ++b)
+        {
+            if (counts[b] > 1)
+            {
+                stableRadixSortChars(first + begin, first + begin + counts[b],
+                        buffer + begin, key, depth + 1);
+            }
+            begin += counts[b];
+        }
+        return;
+    }
+}
+
+// Sorts values by key(value), in place. Elements with equal keys may end up
+// in any order. For strings, key has to return a reference or a string_view,
+// not a new string.
+template <typename T, typename KeyFunction>
+void radixSort(std::vector<T>& values, KeyFunction key)
+{
+    using Key = std::decay_t<decltype(key(std::declval<T const&>()))>;
+    if (values.empty())
+    {
+        return;
+    }
+
+    auto first = values.data();
+    auto last = first + values.size();
+    if constexpr (std::is_arithmetic_v<Key>)
+    {
+        radixSortBytes(first, last, key, sizeof(Key) - 1);
+    }
+    else
+    {
+        radixSortChars(first, last, key, 0);
+    }
+}
+
+template <typename T>
+void radixSort(std::vector<T>& values)
+{
+    radixSort(values, [](T const& value) -> T const&
+            {
+                return value;
+            });
+}
+
+// Sorts values by key(value), keeping elements with equal keys in the order
+// they were in. Uses a buffer as big as values.
+template <typename T, typename KeyFunction>
+void stableRadixSort(std::vector<T>& values, KeyFunction key)
+{
+    using Key = std::decay_t<decltype(key(std::declval<T const&>()))>;
+    if (values.empty())
+    {
+        return;
+    }
+
+    if constexpr (std::is_arithmetic_v<Key>)
+    {
+        stableRadixSortBytes(values, key);
+    }
+    else
+    {
+        RadixBuffer<T> buffer{values.size()};
+        stableRadixSortChars(values.data(), values.data() + values.size(),
+                buffer.data, key, 0);
+    }
+}
+
+template <typename T>
+void stableRadixSort(std::vector<T>& values)
+{
+    stableRadixSort(values, [](T const& value) -> T const&
+            {
+                return value;
+            });
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+// Hands out memory that starts on a cache line, so that we know which
+// elements of a vector share a line.
+template <typename T>
+struct CacheLineAllocator
+{
+    using value_type = T;
+    static constexpr std::size_t CacheLine{64};
+
+    CacheLineAllocator() = default;
+
+    template <typename U>
+    CacheLineAllocator(CacheLineAllocator<U> const&)
+    {  }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T),
+                    std::align_val_t{CacheLine}));
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+        ::operator delete(p, std::align_val_t{CacheLine});
+    }
+
+    template <typename U>
+    bool operator==(CacheLineAllocator<U> const&) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(CacheLineAllocator<U> const&) const
+    {
+        return false;
+    }
+};
+
+// A read-only search index built from a sorted vector. The values are stored
+// in Eytzinger (breadth-first) order, so that the first few levels of the
+// search share the same cache lines and the children of node k always live
+// at 2k and 2k + 1. This lets us prefetch several levels ahead and descend
+// without branching on the comparison.
+//
+// The tree starts at slot 1, and slot 0 sits at the start of a cache line.
+// With elements whose size divides 64, slots k * Prefetch up to
+// k * Prefetch + Prefetch - 1 then fill exactly one line.
+template <typename T>
+class StaticIndex
+{
+public:
+    StaticIndex() = default;
+
+    // The input must already be sorted.
+    StaticIndex(std::vector<T> const& sorted) :
+        mTree(sorted.size() + 1),
+        mRanks(sorted.size() + 1),
+        mSize{sorted.size()}
+    {
+        std::size_t i{0};
+        build(sorted, i, 1);
+    }
+
+    std::size_t size() const
+    {
+        return mSize;
+    }
+
+    bool contains(T const& value) const
+    {
+        auto k = search(value);
+        return k != 0 && !(value < mTree[k]);
+    }
+
+    // Returns the smallest element that is not less than value, if any.
+    std::optional<T> lower_bound(T const& value) const
+    {
+        auto k = search(value);
+        if (k == 0)
+        {
+            return {};
+        }
+
+        return mTree[k];
+    }
+
+    // Returns the number of elements that are strictly less than value. This
+    // is the same as the position std::lower_bound would return on the
+    // original vector.
+    std::size_t rank(T const& value) const
+    {
+        auto k = search(value);
+        if (k == 0)
+        {
+            return mSize;
+        }
+
+        return mRanks[k];
+    }
+
+private:
+    // Fill the tree with an in-order traversal so that the sorted order is
+    // preserved.
+    void build(std::vector<T> const& sorted, std::size_t& i, std::size_t k)
+    {
+        if (k <= mSize)
+        {
+            build(sorted, i, 2 * k);
+            mTree[k] = sorted[i];
+            mRanks[k] = i++;
+            build(sorted, i, 2 * k + 1);
+        }
+    }
+
+    // Returns the slot of the lower bound, or 0 if every element is less than
+    // value.
+    std::size_t search(T const& value) const
+    {
+        std::size_t k{1};
+        while (k <= mSize)
+        {
+            // k * Prefetch is the leftmost descendant of k a few levels down,
+            // and it starts the cache line that holds all the descendants of
+            // k on that level (see the top of the class). Requesting it now
+            // hides the latency of the levels we are about to visit. Near the
+            // bottom that slot is past the end of the tree, so the address is
+            // worked out as an integer rather than a pointer into mTree; a
+            // prefetch of a bad address is simply dropped.
+            auto ahead = reinterpret_cast<std::uintptr_t>(mTree.data()) +
+                k * Prefetch * sizeof(T);
+            __builtin_prefetch(reinterpret_cast<void const*>(ahead));
+            k = 2 * k + (mTree[k] < value);
+        }
+
+        // Every right turn appended a 1 to k and every left turn a 0. The
+        // answer is the last node where we turned left, so drop the trailing
+        // ones and that final zero.
+        k >>= __builtin_ffsll(~k);
+        return k;
+    }
+
+    static constexpr std::size_t Prefetch{
+        sizeof(T) >= 64 ? 1 : 64 / sizeof(T)};
+
+    std::vector<T, CacheLineAllocator<T>> mTree;
+    std::vector<std::size_t> mRanks;
+    std::size_t mSize{0};
+};